@@ -30,6 +30,9 @@
 #include "include/types.h"
 #include "include/log.h"
 #include "include/config.h"
+#include "include/data.h"
+#include "include/flowcache.h"
+#include "include/import.h"
 
 
 #define NVIPFIX_TEST_LOG_RESULT( a_result, a_failResult, a_testResult, a_fmt, ... ) \
@@ -155,8 +158,339 @@ int TestDatetime( void )
 			datetime.year, datetime.month, datetime.day, datetime.hours, datetime.minutes,
 			(int)nvipfix_timespan_get_minutes( &(datetime.tzOffset) ) );
 
+	const char * iso8601 = "2016-09-22T20:13:11.250+03:00";
+	nvIPFIX_I64 microseconds = 0;
+	NVIPFIX_TEST_LOG_RESULT( result, 4,
+			nvipfix_datetime_parse_iso8601( iso8601, strlen( iso8601 ), &datetime, &microseconds )
+			&& microseconds == 1474564391250000LL && datetime.milliseconds == 250,
+			"%s: microseconds = %lld\n", iso8601, (long long)microseconds );
+
+	nvIPFIX_datetime_t datetimeZone = { 0 };
+	const char * iso8601Zone = "2016-09-22T23:13:11+03:00";
+	iso8601 = "2016-09-22T20:13:11Z";
+	NVIPFIX_TEST_LOG_RESULT( result, 4, nvipfix_parse_datetime_iso8601( iso8601, &datetime )
+			&& nvipfix_parse_datetime_iso8601( iso8601Zone, &datetimeZone )
+			&& nvipfix_datetime_to_ctime( &datetime ) == (time_t)1474575191
+			&& nvipfix_datetime_to_ctime( &datetimeZone ) == (time_t)1474575191,
+			"%s, %s: %f, %f\n", iso8601, iso8601Zone,
+			(double)nvipfix_datetime_to_ctime( &datetime ), (double)nvipfix_datetime_to_ctime( &datetimeZone ) );
+
+	iso8601 = "2015-02-29T00:00:00Z";
+	NVIPFIX_TEST_LOG_RESULT( result, 4, !nvipfix_parse_datetime_iso8601( iso8601, &datetime ),
+			"%s: rejected\n", iso8601 );
+
+	return result;
+}
+
+int TestParseInteger( void )
+{
+#undef fmt
+#define fmt "s = '%s', status = %d, value = %llu\n"
+
+	int result = 0;
+	const char * s[] = { "0", "123456789", "18446744073709551615", "18446744073709551616", "1234567/", "" };
+	const nvIPFIX_PARSE_STATUS status[] = { NV_IPFIX_PARSE_STATUS_OK, NV_IPFIX_PARSE_STATUS_OK,
+			NV_IPFIX_PARSE_STATUS_OK, NV_IPFIX_PARSE_STATUS_OVERFLOW,
+			NV_IPFIX_PARSE_STATUS_INVALID, NV_IPFIX_PARSE_STATUS_INVALID };
+	const nvIPFIX_U64 value[] = { 0, 123456789, UINT64_MAX, 0, 0, 0 };
+
+	for (size_t i = 0; i < sizeof s / sizeof s[0]; i++) {
+		nvIPFIX_U64 u64Value = 0;
+		nvIPFIX_PARSE_STATUS parseStatus = nvipfix_parse_decimal_u64( s[i], strlen( s[i] ), &u64Value );
+
+		NVIPFIX_TEST_LOG_RESULT( result, 8, parseStatus == status[i] && u64Value == value[i],
+				fmt, s[i], (int)parseStatus, (unsigned long long)u64Value );
+	}
+
+	nvIPFIX_U16 u16Value = 0;
+	NVIPFIX_TEST_LOG_RESULT( result, 8, !nvipfix_parse_u16( "65536", &u16Value ) && u16Value == 0,
+			fmt, "65536", 0, (unsigned long long)u16Value );
+
+	int intValue = 0;
+	NVIPFIX_TEST_LOG_RESULT( result, 8, nvipfix_parse_u16( " 2 ", &u16Value ) && u16Value == 2
+			&& nvipfix_parse_int( "\t-3 ", &intValue ) && intValue == -3,
+			fmt, " 2 ", 0, (unsigned long long)u16Value );
+
+	return result;
+}
+
+int TestFlowCacheVxlan( void )
+{
+	int result = 0;
+	nvIPFIX_flowcache_t * cache = nvipfix_flowcache_create( 16, 60, 0 );
+	time_t now = time( NULL );
+
+	nvIPFIX_data_record_t flow1 = {
+			.sourceIp = { .value = 0x0A000001, .hasValue = true },
+			.destinationIp = { .value = 0x0A000002, .hasValue = true },
+			.sourcePort = 40000,
+			.destinationPort = 80,
+			.protocol = 6,
+			.layer2SegmentId = ((nvIPFIX_U64)NV_IPFIX_LAYER2_NETWORK_TYPE_VxLAN << 56) | 100,
+			.transportOctetDeltaCount = 1000
+	};
+	nvIPFIX_data_record_t flow2 = flow1;
+	flow2.layer2SegmentId = ((nvIPFIX_U64)NV_IPFIX_LAYER2_NETWORK_TYPE_VxLAN << 56) | 200;
+	flow2.transportOctetDeltaCount = 300;
+
+	NVIPFIX_TEST_LOG_RESULT( result, 16, cache != NULL
+			&& nvipfix_flowcache_update( cache, &flow1, now ) && nvipfix_flowcache_update( cache, &flow2, now )
+			&& nvipfix_flowcache_get_count( cache ) == 2 && flow2.transportOctetDeltaCount == 300,
+			"flows = %u, delta = %llu\n", (unsigned)((cache != NULL) ? nvipfix_flowcache_get_count( cache ) : 0),
+			(unsigned long long)flow2.transportOctetDeltaCount );
+
+	nvipfix_flowcache_free( cache );
+
+	return result;
+}
+
+void FlowCacheInitRecord( nvIPFIX_data_record_t * a_record, nvIPFIX_U16 a_sourcePort, nvIPFIX_U64 a_octets )
+{
+	memset( a_record, 0, sizeof (nvIPFIX_data_record_t) );
+
+	a_record->sourceIp.value = 0x0A000001;
+	a_record->sourceIp.hasValue = true;
+	a_record->destinationIp.value = 0x0A000002;
+	a_record->destinationIp.hasValue = true;
+	a_record->sourcePort = a_sourcePort;
+	a_record->destinationPort = 443;
+	a_record->protocol = NV_IPFIX_PROTOCOL_TCP;
+	a_record->transportOctetDeltaCount = a_octets;
+	a_record->initiatorOctets = a_octets / 2;
+	a_record->responderOctets = a_octets - a_octets / 2;
+}
+
+int TestFlowCache( void )
+{
+	enum {
+		FlowsCount = 64
+	};
+
+	int result = 0;
+	nvIPFIX_flowcache_t * cache = nvipfix_flowcache_create( FlowsCount, 60, 0 );
+	time_t now = time( NULL );
+	nvIPFIX_data_record_t record;
+
+	if (cache == NULL) {
+		puts( "nvipfix_flowcache_create failed" );
+		return 64;
+	}
+
+	FlowCacheInitRecord( &record, 40000, 1000 );
+	bool isExported = nvipfix_flowcache_update( cache, &record, now );
+	NVIPFIX_TEST_LOG_RESULT( result, 64, isExported && record.transportOctetDeltaCount == 1000,
+			"new flow: exported = %d, delta = %llu\n", (int)isExported, (unsigned long long)record.transportOctetDeltaCount );
+
+	FlowCacheInitRecord( &record, 40000, 1500 );
+	isExported = nvipfix_flowcache_update( cache, &record, now + 10 );
+	NVIPFIX_TEST_LOG_RESULT( result, 64, isExported && record.transportOctetDeltaCount == 500
+			&& record.initiatorOctets == 250 && record.responderOctets == 250,
+			"second update: exported = %d, delta = %llu\n", (int)isExported,
+			(unsigned long long)record.transportOctetDeltaCount );
+
+	FlowCacheInitRecord( &record, 40000, 1500 );
+	isExported = nvipfix_flowcache_update( cache, &record, now + 20 );
+	NVIPFIX_TEST_LOG_RESULT( result, 64, !isExported,
+			"unchanged flow: exported = %d\n", (int)isExported );
+
+	/*
+	 * counters going down: a new connection reusing the key, exported with its own totals
+	 */
+	FlowCacheInitRecord( &record, 40000, 200 );
+	isExported = nvipfix_flowcache_update( cache, &record, now + 30 );
+	NVIPFIX_TEST_LOG_RESULT( result, 64, isExported && record.transportOctetDeltaCount == 200
+			&& nvipfix_flowcache_get_count( cache ) == 1,
+			"counter reset: exported = %d, delta = %llu\n", (int)isExported,
+			(unsigned long long)record.transportOctetDeltaCount );
+
+	nvipfix_flowcache_free( cache );
+
+	/*
+	 * a full index of 2 slots per flow has probe chains; every other flow expires
+	 * and the flows left behind it in a chain must still be found
+	 */
+	cache = nvipfix_flowcache_create( FlowsCount, 60, 0 );
+
+	if (cache == NULL) {
+		puts( "nvipfix_flowcache_create failed" );
+		return 64;
+	}
+
+	for (nvIPFIX_U16 i = 0; i < FlowsCount; i++) {
+		FlowCacheInitRecord( &record, 40000 + i, 100 );
+		nvipfix_flowcache_update( cache, &record, now + ((i % 2 == 0) ? 0 : 30) );
+	}
+
+	size_t expiredCount = nvipfix_flowcache_expire( cache, now + 60 );
+	size_t foundCount = 0;
+
+	for (nvIPFIX_U16 i = 1; i < FlowsCount; i += 2) {
+		FlowCacheInitRecord( &record, 40000 + i, 100 );
+		foundCount += nvipfix_flowcache_update( cache, &record, now + 61 ) ? 0 : 1;
+	}
+
+	NVIPFIX_TEST_LOG_RESULT( result, 64, expiredCount == FlowsCount / 2 && foundCount == FlowsCount / 2
+			&& nvipfix_flowcache_get_count( cache ) == FlowsCount / 2,
+			"expiry: expired = %zu, found = %zu, flows = %zu\n", expiredCount, foundCount,
+			nvipfix_flowcache_get_count( cache ) );
+
+	/*
+	 * the expired flows come back as new ones into the freed entries
+	 */
+	size_t newCount = 0;
+
+	for (nvIPFIX_U16 i = 0; i < FlowsCount; i += 2) {
+		FlowCacheInitRecord( &record, 40000 + i, 100 );
+		newCount += (nvipfix_flowcache_update( cache, &record, now + 62 ) && record.transportOctetDeltaCount == 100) ? 1 : 0;
+	}
+
+	NVIPFIX_TEST_LOG_RESULT( result, 64, newCount == FlowsCount / 2 && nvipfix_flowcache_get_count( cache ) == FlowsCount,
+			"re-added: new = %zu, flows = %zu\n", newCount, nvipfix_flowcache_get_count( cache ) );
+
+	/*
+	 * once full, a new flow is passed through with its total counters every time, nothing is evicted
+	 */
+	FlowCacheInitRecord( &record, 50000, 700 );
+	isExported = nvipfix_flowcache_update( cache, &record, now + 63 );
+	FlowCacheInitRecord( &record, 50000, 700 );
+	isExported = isExported && nvipfix_flowcache_update( cache, &record, now + 64 );
+	NVIPFIX_TEST_LOG_RESULT( result, 64, isExported && record.transportOctetDeltaCount == 700
+			&& nvipfix_flowcache_get_count( cache ) == FlowsCount,
+			"full: exported = %d, delta = %llu, flows = %zu\n", (int)isExported,
+			(unsigned long long)record.transportOctetDeltaCount, nvipfix_flowcache_get_count( cache ) );
+
+	FlowCacheInitRecord( &record, 40001, 100 );
+	isExported = nvipfix_flowcache_update( cache, &record, now + 65 );
+	NVIPFIX_TEST_LOG_RESULT( result, 64, !isExported,
+			"full, cached flow: exported = %d\n", (int)isExported );
+
+	nvipfix_flowcache_free( cache );
+
+	return result;
+}
+
+int TestFlowCacheTransition( void )
+{
+	int result = 0;
+	nvIPFIX_flowcache_t * cache = nvipfix_flowcache_create( 16, 600, 300 );
+	time_t now = time( NULL );
+	nvIPFIX_data_record_t record;
+
+	if (cache == NULL) {
+		puts( "nvipfix_flowcache_create failed" );
+		return 128;
+	}
+
+	/*
+	 * the end of a flow is exported once even with unchanged counters, later reports of it are dropped
+	 */
+	FlowCacheInitRecord( &record, 40000, 1000 );
+	record.transition = NV_IPFIX_FLOW_TRANSITION_RUNNING;
+	bool isExported = nvipfix_flowcache_update( cache, &record, now );
+
+	FlowCacheInitRecord( &record, 40000, 1000 );
+	record.transition = NV_IPFIX_FLOW_TRANSITION_ENDED;
+	bool isEndExported = nvipfix_flowcache_update( cache, &record, now + 10 );
+
+	FlowCacheInitRecord( &record, 40000, 1000 );
+	record.transition = NV_IPFIX_FLOW_TRANSITION_ENDED;
+	bool isRepeatExported = nvipfix_flowcache_update( cache, &record, now + 20 );
+
+	FlowCacheInitRecord( &record, 40000, 1000 );
+	record.transition = NV_IPFIX_FLOW_TRANSITION_ENDED;
+	isRepeatExported = isRepeatExported || nvipfix_flowcache_update( cache, &record, now + 400 );
+
+	NVIPFIX_TEST_LOG_RESULT( result, 128, isExported && isEndExported && record.transportOctetDeltaCount == 0
+			&& !isRepeatExported,
+			"ended flow: end exported = %d, repeated end exported = %d\n", (int)isEndExported, (int)isRepeatExported );
+
+	/*
+	 * an unchanged running flow is exported again once the active timeout has passed since its last export
+	 */
+	FlowCacheInitRecord( &record, 40001, 1000 );
+	record.transition = NV_IPFIX_FLOW_TRANSITION_RUNNING;
+	isExported = nvipfix_flowcache_update( cache, &record, now );
+
+	FlowCacheInitRecord( &record, 40001, 1000 );
+	record.transition = NV_IPFIX_FLOW_TRANSITION_RUNNING;
+	bool isEarlyExported = nvipfix_flowcache_update( cache, &record, now + 299 );
+
+	FlowCacheInitRecord( &record, 40001, 1000 );
+	record.transition = NV_IPFIX_FLOW_TRANSITION_RUNNING;
+	bool isRefreshed = nvipfix_flowcache_update( cache, &record, now + 300 );
+
+	FlowCacheInitRecord( &record, 40001, 1000 );
+	record.transition = NV_IPFIX_FLOW_TRANSITION_RUNNING;
+	bool isLateExported = nvipfix_flowcache_update( cache, &record, now + 310 );
+
+	NVIPFIX_TEST_LOG_RESULT( result, 128, isExported && !isEarlyExported && isRefreshed && !isLateExported,
+			"active timeout: before = %d, at = %d, after = %d\n", (int)isEarlyExported, (int)isRefreshed,
+			(int)isLateExported );
+
+	nvipfix_flowcache_free( cache );
+
+	/*
+	 * no active timeout: an unchanged running flow is never exported again
+	 */
+	cache = nvipfix_flowcache_create( 16, 600, 0 );
+
+	if (cache == NULL) {
+		puts( "nvipfix_flowcache_create failed" );
+		return 128;
+	}
+
+	FlowCacheInitRecord( &record, 40002, 1000 );
+	record.transition = NV_IPFIX_FLOW_TRANSITION_RUNNING;
+	isExported = nvipfix_flowcache_update( cache, &record, now );
+	isRefreshed = false;
+
+	for (time_t t = now + 300; t <= now + 3600; t += 300) {
+		FlowCacheInitRecord( &record, 40002, 1000 );
+		record.transition = NV_IPFIX_FLOW_TRANSITION_RUNNING;
+		isRefreshed = isRefreshed || nvipfix_flowcache_update( cache, &record, t );
+	}
+
+	NVIPFIX_TEST_LOG_RESULT( result, 128, isExported && !isRefreshed,
+			"no active timeout: refreshed = %d\n", (int)isRefreshed );
+
+	nvipfix_flowcache_free( cache );
+
+	return result;
+}
+
+#ifdef NVIPFIX_DEF_ENABLE_NVC
+int TestNvcSumBySplit( void )
+{
+	int result = 0;
+	const nvIPFIX_conn_format_t sumBy = { .sumBy = "vlan" };
+	const time_t start = 0, end = 120, middle = 60;
+	const nvIPFIX_U32 chunkSize = 2;
+
+	/*
+	 * the switch cut the window at the chunk size; one connection runs from 30 to 90 s
+	 * and each sub-window it is active in reports its full total in the row of its vlan
+	 */
+	const time_t connStart = 30, connEnd = 90;
+	const nvIPFIX_U64 connOctets = 1000;
+
+	bool isSplit = nvipfix_import_nvc_is_split_useful( end - start, chunkSize, 0, chunkSize, &sumBy );
+	nvIPFIX_U64 octets = 0;
+
+	if (isSplit) {
+		octets += (connStart < middle) ? connOctets : 0;
+		octets += (connEnd >= middle) ? connOctets : 0;
+	}
+	else {
+		octets = connOctets;
+	}
+
+	NVIPFIX_TEST_LOG_RESULT( result, 32, !isSplit && octets == connOctets
+			&& nvipfix_import_nvc_is_split_useful( end - start, chunkSize, 0, chunkSize, NULL ),
+			"split = %d, octets = %llu\n", (int)isSplit, (unsigned long long)octets );
+
 	return result;
 }
+#endif
 
 int main( int argc, char * argv[] )
 {
@@ -164,6 +498,13 @@ int main( int argc, char * argv[] )
 	rc = TestHashtable8();
 	rc |= TestConfig();
 	rc |= TestDatetime();
+	rc |= TestParseInteger();
+	rc |= TestFlowCacheVxlan();
+	rc |= TestFlowCache();
+	rc |= TestFlowCacheTransition();
+#ifdef NVIPFIX_DEF_ENABLE_NVC
+	rc |= TestNvcSumBySplit();
+#endif
 
 	printf( "test result = %d\n", rc );
 
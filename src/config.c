@@ -28,6 +28,7 @@
 #include "include/log.h"
 #include "include/fwatch.h"
 
+#include "include/data.h"
 #include "include/config.h"
 
 
@@ -68,6 +69,10 @@ static void nvipfix_config_add_collector( nvIPFIX_collector_info_t * );
 static bool nvipfix_config_is_empty_line( char * a_line );
 
 static bool nvipfix_config_parse_transport( const char *, void * );
+static bool nvipfix_config_parse_nvc_export_mode( const char *, void * );
+static bool nvipfix_config_parse_protocol( const char *, void * );
+static bool nvipfix_config_parse_vlan( const char *, void * );
+static bool nvipfix_config_parse_port( const char *, void * );
 
 static const nvIPFIX_setting_t * nvipfix_config_get_setting( const char *, int );
 
@@ -79,18 +84,39 @@ enum {
 	SizeofCollectorInfoListItem = sizeof (nvIPFIX_collector_info_list_item_t)
 };
 
+enum {
+	FilterVlanMax = 4095
+};
+
 enum {
 	SettingIdSwitch = 1,
 	SettingIdSwitchApiHost,
 	SettingIdSwitchApiLogin,
 	SettingIdSwitchApiPassword,
 	SettingIdExportInterval,
+	SettingIdNvcChunkSize,
+	SettingIdNvcExportMode,
+	SettingIdNvcConnections,
+	SettingIdNvcPollDeadline,
+	SettingIdFilter,
+	SettingIdFilterVlan,
+	SettingIdFilterVnet,
+	SettingIdFilterClientPort,
+	SettingIdFilterServerPort,
+	SettingIdFilterProtocol,
+	SettingIdNvcSumBy,
+	SettingIdNvcSortAsc,
+	SettingIdNvcSortDesc,
+	SettingIdFlowCacheSize,
+	SettingIdFlowCacheTimeout,
+	SettingIdFlowCacheActiveTimeout,
 	SettingIdCollector,
 	SettingIdCollectorIpAddress,
 	SettingIdCollectorHostname,
 	SettingIdCollectorTransport,
 	SettingIdCollectorTransportPort,
-	SettingIdCollectorDscp
+	SettingIdCollectorDscp,
+	SettingIdCollectorExportFields
 };
 
 static char * SwitchName = NULL;
@@ -99,6 +125,15 @@ static char * SwitchApiLogin = NULL;
 static char * SwitchApiPassword = NULL;
 
 static NVIPFIX_TIMESPAN_INIT_FROM_SECONDS( ExportInterval, 60 );
+static nvIPFIX_U32 NvcChunkSize = 10000;
+static nvIPFIX_NVC_EXPORT_MODE NvcExportMode = NV_IPFIX_NVC_EXPORT_CHUNKED;
+static nvIPFIX_U32 NvcConnections = 1;
+static nvIPFIX_U32 NvcPollDeadline = 80;
+static nvIPFIX_conn_filter_t ConnFilter = { .vlan = -1, .vnet = NULL, .clientPort = -1, .serverPort = -1, .protocol = -1 };
+static nvIPFIX_conn_format_t ConnFormat = { .sumBy = NULL, .sortAsc = NULL, .sortDesc = NULL };
+static nvIPFIX_U32 FlowCacheSize = 0;
+static NVIPFIX_TIMESPAN_INIT_FROM_SECONDS( FlowCacheTimeout, 300 );
+static NVIPFIX_TIMESPAN_INIT_FROM_SECONDS( FlowCacheActiveTimeout, 0 );
 
 static const nvIPFIX_setting_t Settings[] = {
 		NVIPFIX_CONFIG_SETTING( "switch", SettingIdSwitch, 0,
@@ -116,6 +151,54 @@ static const nvIPFIX_setting_t Settings[] = {
 		NVIPFIX_CONFIG_SETTING( "export-interval", SettingIdExportInterval, 0,
 				&ExportInterval, 0, nvipfix_parse_timespan ),
 
+		NVIPFIX_CONFIG_SETTING( "nvc-chunk-size", SettingIdNvcChunkSize, 0,
+				&NvcChunkSize, 0, nvipfix_parse_u32 ),
+
+		NVIPFIX_CONFIG_SETTING( "nvc-export-mode", SettingIdNvcExportMode, 0,
+				&NvcExportMode, 0, nvipfix_config_parse_nvc_export_mode ),
+
+		NVIPFIX_CONFIG_SETTING( "nvc-connections", SettingIdNvcConnections, 0,
+				&NvcConnections, 0, nvipfix_parse_u32 ),
+
+		NVIPFIX_CONFIG_SETTING( "nvc-poll-deadline", SettingIdNvcPollDeadline, 0,
+				&NvcPollDeadline, 0, nvipfix_parse_u32 ),
+
+		NVIPFIX_CONFIG_SETTING( "filter", SettingIdFilter, 0,
+				NULL, 0, NULL ),
+
+		NVIPFIX_CONFIG_SETTING( "vlan", SettingIdFilterVlan, SettingIdFilter,
+				&ConnFilter.vlan, 0, nvipfix_config_parse_vlan ),
+
+		NVIPFIX_CONFIG_SETTING( "vnet", SettingIdFilterVnet, SettingIdFilter,
+				&ConnFilter.vnet, 0, nvipfix_parse_string ),
+
+		NVIPFIX_CONFIG_SETTING( "client-port", SettingIdFilterClientPort, SettingIdFilter,
+				&ConnFilter.clientPort, 0, nvipfix_config_parse_port ),
+
+		NVIPFIX_CONFIG_SETTING( "server-port", SettingIdFilterServerPort, SettingIdFilter,
+				&ConnFilter.serverPort, 0, nvipfix_config_parse_port ),
+
+		NVIPFIX_CONFIG_SETTING( "protocol", SettingIdFilterProtocol, SettingIdFilter,
+				&ConnFilter.protocol, 0, nvipfix_config_parse_protocol ),
+
+		NVIPFIX_CONFIG_SETTING( "nvc-sum-by", SettingIdNvcSumBy, 0,
+				&ConnFormat.sumBy, 0, nvipfix_parse_string ),
+
+		NVIPFIX_CONFIG_SETTING( "nvc-sort-asc", SettingIdNvcSortAsc, 0,
+				&ConnFormat.sortAsc, 0, nvipfix_parse_string ),
+
+		NVIPFIX_CONFIG_SETTING( "nvc-sort-desc", SettingIdNvcSortDesc, 0,
+				&ConnFormat.sortDesc, 0, nvipfix_parse_string ),
+
+		NVIPFIX_CONFIG_SETTING( "flow-cache-size", SettingIdFlowCacheSize, 0,
+				&FlowCacheSize, 0, nvipfix_parse_u32 ),
+
+		NVIPFIX_CONFIG_SETTING( "flow-cache-timeout", SettingIdFlowCacheTimeout, 0,
+				&FlowCacheTimeout, 0, nvipfix_parse_timespan ),
+
+		NVIPFIX_CONFIG_SETTING( "flow-cache-active-timeout", SettingIdFlowCacheActiveTimeout, 0,
+				&FlowCacheActiveTimeout, 0, nvipfix_parse_timespan ),
+
 		NVIPFIX_CONFIG_SETTING_COLLECTOR( "collector", SettingIdCollector, 0,
 				NULL, name, nvipfix_parse_string ),
 
@@ -134,6 +217,9 @@ static const nvIPFIX_setting_t Settings[] = {
 		NVIPFIX_CONFIG_SETTING_COLLECTOR( "dscp", SettingIdCollectorDscp, SettingIdCollector,
 				NULL, dscp, nvipfix_parse_octet ),
 
+		NVIPFIX_CONFIG_SETTING_COLLECTOR( "export-fields", SettingIdCollectorExportFields, SettingIdCollector,
+				NULL, exportFields, nvipfix_parse_string ),
+
 		{ NULL }
 };
 
@@ -226,11 +312,18 @@ void nvipfix_config_read( void )
 					}
 					else if (tokenIndex == 2) {
 						if (setting != NULL) {
+							bool isParsed = true;
+
 							if (parentId == SettingIdCollector) {
-								setting->parseValue( token->value, ((char *)&collector) + setting->offset );
+								isParsed = setting->parseValue( token->value, ((char *)&collector) + setting->offset );
+							}
+							else if (setting->value != NULL) {
+								isParsed = setting->parseValue( token->value, setting->value );
 							}
-							else if (parentId == 0) {
-								setting->parseValue( token->value, setting->value );
+
+							if (!isParsed) {
+								nvipfix_log_error( "%s: invalid value '%s' for setting '%s', %d", __func__,
+										token->value, setting->name, line );
 							}
 						}
 					}
@@ -278,6 +371,18 @@ void nvipfix_config_cleanup( void )
 	free( SwitchApiPassword );
 	SwitchApiPassword = NULL;
 
+	free( (void *)ConnFilter.vnet );
+	ConnFilter.vnet = NULL;
+
+	free( (void *)ConnFormat.sumBy );
+	ConnFormat.sumBy = NULL;
+
+	free( (void *)ConnFormat.sortAsc );
+	ConnFormat.sortAsc = NULL;
+
+	free( (void *)ConnFormat.sortDesc );
+	ConnFormat.sortDesc = NULL;
+
 	nvIPFIX_collector_info_list_item_t * listPtr = CollectorList;
 
 	while (listPtr != NULL) {
@@ -285,6 +390,7 @@ void nvipfix_config_cleanup( void )
 		free( (void *)tPtr->current->name );
 		free( (void *)tPtr->current->host );
 		free( (void *)tPtr->current->port );
+		free( (void *)tPtr->current->exportFields );
 
 		listPtr = listPtr->next;
 		free( tPtr );
@@ -371,6 +477,92 @@ bool nvipfix_config_parse_transport( const char * a_s, void * a_value )
 	return result;
 }
 
+bool nvipfix_config_parse_nvc_export_mode( const char * a_s, void * a_value )
+{
+	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
+
+	bool result = true;
+	nvIPFIX_NVC_EXPORT_MODE * mode = a_value;
+
+	if (strcmp( "chunked", a_s ) == 0) {
+		*mode = NV_IPFIX_NVC_EXPORT_CHUNKED;
+	}
+	else if (strcmp( "streaming", a_s ) == 0) {
+		*mode = NV_IPFIX_NVC_EXPORT_STREAMING;
+	}
+	else {
+		result = false;
+	}
+
+	return result;
+}
+
+bool nvipfix_config_parse_protocol( const char * a_s, void * a_value )
+{
+	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
+
+	bool result = true;
+	int * protocol = a_value;
+
+	if (strcmp( "tcp", a_s ) == 0) {
+		*protocol = NV_IPFIX_PROTOCOL_TCP;
+	}
+	else if (strcmp( "udp", a_s ) == 0) {
+		*protocol = NV_IPFIX_PROTOCOL_UDP;
+	}
+	else if (strcmp( "icmp", a_s ) == 0) {
+		*protocol = NV_IPFIX_PROTOCOL_ICMP;
+	}
+	else {
+		nvIPFIX_BYTE value;
+
+		result = nvipfix_parse_byte( a_s, &value );
+		*protocol = result ? value : *protocol;
+	}
+
+	return result;
+}
+
+/**
+ * VLAN id of the filter, 0..4095
+ * @param a_s
+ * @param a_value int
+ * @return
+ */
+bool nvipfix_config_parse_vlan( const char * a_s, void * a_value )
+{
+	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
+
+	nvIPFIX_U16 value;
+	bool result = nvipfix_parse_u16( a_s, &value ) && value <= FilterVlanMax;
+
+	if (result) {
+		*((int *)a_value) = value;
+	}
+
+	return result;
+}
+
+/**
+ * port of the filter, 0..65535
+ * @param a_s
+ * @param a_value int
+ * @return
+ */
+bool nvipfix_config_parse_port( const char * a_s, void * a_value )
+{
+	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
+
+	nvIPFIX_U16 value;
+	bool result = nvipfix_parse_u16( a_s, &value );
+
+	if (result) {
+		*((int *)a_value) = value;
+	}
+
+	return result;
+}
+
 const nvIPFIX_setting_t * nvipfix_config_get_setting( const char * a_name, int a_parentId )
 {
 	const nvIPFIX_setting_t * result = NULL;
@@ -417,3 +609,66 @@ nvIPFIX_timespan_t nvipfix_config_get_export_interval( void )
 
 	return ExportInterval;
 }
+
+nvIPFIX_U32 nvipfix_config_get_nvc_chunk_size( void )
+{
+	nvipfix_config_init();
+
+	return NvcChunkSize;
+}
+
+nvIPFIX_NVC_EXPORT_MODE nvipfix_config_get_nvc_export_mode( void )
+{
+	nvipfix_config_init();
+
+	return NvcExportMode;
+}
+
+nvIPFIX_U32 nvipfix_config_get_nvc_connections( void )
+{
+	nvipfix_config_init();
+
+	return NvcConnections;
+}
+
+nvIPFIX_U32 nvipfix_config_get_nvc_poll_deadline( void )
+{
+	nvipfix_config_init();
+
+	return NvcPollDeadline;
+}
+
+const nvIPFIX_conn_filter_t * nvipfix_config_get_conn_filter( void )
+{
+	nvipfix_config_init();
+
+	return &ConnFilter;
+}
+
+const nvIPFIX_conn_format_t * nvipfix_config_get_conn_format( void )
+{
+	nvipfix_config_init();
+
+	return &ConnFormat;
+}
+
+nvIPFIX_U32 nvipfix_config_get_flow_cache_size( void )
+{
+	nvipfix_config_init();
+
+	return FlowCacheSize;
+}
+
+nvIPFIX_timespan_t nvipfix_config_get_flow_cache_timeout( void )
+{
+	nvipfix_config_init();
+
+	return FlowCacheTimeout;
+}
+
+nvIPFIX_timespan_t nvipfix_config_get_flow_cache_active_timeout( void )
+{
+	nvipfix_config_init();
+
+	return FlowCacheActiveTimeout;
+}
@@ -65,6 +65,52 @@ nvIPFIX_data_record_list_t * nvipfix_data_list_add_copy( nvIPFIX_data_record_lis
 	return result;
 }
 
+nvIPFIX_data_record_list_t * nvipfix_data_list_concat( nvIPFIX_data_record_list_t * a_list, nvIPFIX_data_record_list_t * a_other )
+{
+	NVIPFIX_NULL_ARGS_GUARD_1( a_list, a_other );
+	NVIPFIX_NULL_ARGS_GUARD_1( a_other, a_list );
+
+	if (a_other->head != NULL) {
+		if (a_list->tail != NULL) {
+			a_list->tail->next = a_other->head;
+			a_other->head->prev = a_list->tail;
+		}
+		else {
+			a_list->head = a_other->head;
+		}
+
+		a_list->tail = a_other->tail;
+	}
+
+	free( a_other );
+
+	return a_list;
+}
+
+nvIPFIX_data_record_list_t * nvipfix_data_list_remove( nvIPFIX_data_record_list_t * a_list, nvIPFIX_data_record_t * a_record )
+{
+	NVIPFIX_NULL_ARGS_GUARD_2( a_list, a_record, a_list );
+
+	if (a_record->prev != NULL) {
+		a_record->prev->next = a_record->next;
+	}
+	else {
+		a_list->head = a_record->next;
+	}
+
+	if (a_record->next != NULL) {
+		a_record->next->prev = a_record->prev;
+	}
+	else {
+		a_list->tail = a_record->prev;
+	}
+
+	a_record->prev = NULL;
+	a_record->next = NULL;
+
+	return a_list;
+}
+
 void nvipfix_data_list_free( nvIPFIX_data_record_list_t * a_list )
 {
 	NVIPFIX_NULL_ARGS_GUARD_1_VOID( a_list );
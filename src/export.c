@@ -19,6 +19,7 @@
  */
 
 #include <stdbool.h>
+#include <string.h>
 
 #include "fixbuf/public.h"
 
@@ -31,6 +32,11 @@
 
 #define NVIPFIX_TEMPLATE_ITEM( a_name ) { .name = a_name, .len_override = 0, .flags = 0 }
 
+/*
+ * Template[] item i is included in an export template if bit i of the template flags is set
+ */
+#define NVIPFIX_TEMPLATE_FLAG( a_index ) ((uint32_t)1 << (a_index))
+
 
 typedef struct {
 	uint64_t messageCount;
@@ -43,8 +49,13 @@ typedef struct {
 	fBuf_t	*buffer;
 	uint16_t templateId;
 	uint16_t templateIdExt;
+	uint16_t templateIdAggregated;	//!< 0 until records are aggregated
 	uint16_t statsTemplateId;
 	uint16_t  statsTemplateIdExt;
+	uint32_t exportFlags;			//!< template flags of the collector's export-fields
+	uint32_t startTs;				//!< flow start of records without one, seconds since epoch
+	uint32_t endTs;					//!< flow end of records without one
+	int recordCount;				//!< records appended since nvipfix_export_begin
 } nvIPFIX_collector_private_t;
 
 typedef struct {
@@ -56,6 +67,7 @@ typedef struct {
     uint64_t transportOctetDeltaCount;
     uint64_t initiatorOctets;
     uint64_t responderOctets;
+    uint64_t deltaFlowCount;
 
     uint64_t latencyMicroseconds;
     uint32_t flowDurationMilliseconds;
@@ -84,6 +96,14 @@ typedef struct {
 	uint64_t exportedFlowRecordTotalCount;
 } nvIPFIX_export_stats_data_t;
 
+/**
+ * sum-by key of the switch and the IE holding it
+ */
+typedef struct {
+	const char * key;
+	const char * name;
+} nvIPFIX_export_sum_by_key_t;
+
 
 static const char * InfoElementLatencyName = NVIPFIX_IE_LATENCY_NAME;
 
@@ -94,6 +114,7 @@ static fbInfoElementSpec_t Template[] = {
 		NVIPFIX_TEMPLATE_ITEM( "transportOctetDeltaCount" ),
 		NVIPFIX_TEMPLATE_ITEM( "initiatorOctets" ),
 		NVIPFIX_TEMPLATE_ITEM( "responderOctets" ),
+		NVIPFIX_TEMPLATE_ITEM( "deltaFlowCount" ),
 		NVIPFIX_TEMPLATE_ITEM( NVIPFIX_IE_LATENCY_NAME ),
 		NVIPFIX_TEMPLATE_ITEM( "flowDurationMilliseconds" ),
 		NVIPFIX_TEMPLATE_ITEM( "ingressInterface" ),
@@ -111,6 +132,62 @@ static fbInfoElementSpec_t Template[] = {
 		FB_IESPEC_NULL
 };
 
+/*
+ * data record fields each Template[] item is built from, in the same order
+ */
+static const nvIPFIX_U32 TemplateRecordFields[] = {
+		NV_IPFIX_DATA_FIELD_FLOW_START,
+		NV_IPFIX_DATA_FIELD_FLOW_END,
+		NV_IPFIX_DATA_FIELD_LAYER2_SEGMENT_ID,
+		NV_IPFIX_DATA_FIELD_TRANSPORT_OCTET_DELTA_COUNT,
+		NV_IPFIX_DATA_FIELD_INITIATOR_OCTETS,
+		NV_IPFIX_DATA_FIELD_RESPONDER_OCTETS,
+		NV_IPFIX_DATA_FIELD_FLOW_COUNT,
+		NV_IPFIX_DATA_FIELD_LATENCY,
+		NV_IPFIX_DATA_FIELD_FLOW_DURATION,
+		NV_IPFIX_DATA_FIELD_INGRESS_INTERFACE,
+		NV_IPFIX_DATA_FIELD_EGRESS_INTERFACE,
+		NV_IPFIX_DATA_FIELD_VLAN_ID,
+		NV_IPFIX_DATA_FIELD_ETHERNET_TYPE,
+		NV_IPFIX_DATA_FIELD_SOURCE_IP,
+		NV_IPFIX_DATA_FIELD_DESTINATION_IP,
+		NV_IPFIX_DATA_FIELD_SOURCE_PORT,
+		NV_IPFIX_DATA_FIELD_DESTINATION_PORT,
+		NV_IPFIX_DATA_FIELD_SOURCE_MAC,
+		NV_IPFIX_DATA_FIELD_DESTINATION_MAC,
+		NV_IPFIX_DATA_FIELD_PROTOCOL,
+		NV_IPFIX_DATA_FIELD_TCP_CONTROL_BITS
+};
+
+static const size_t TemplateCount = (sizeof TemplateRecordFields) / sizeof (nvIPFIX_U32);
+
+/*
+ * an aggregated record holds its sum-by keys and these
+ */
+static const nvIPFIX_U32 AggregatedRecordFields = NV_IPFIX_DATA_FIELD_FLOW_START
+		| NV_IPFIX_DATA_FIELD_FLOW_END
+		| NV_IPFIX_DATA_FIELD_TRANSPORT_OCTET_DELTA_COUNT
+		| NV_IPFIX_DATA_FIELD_INITIATOR_OCTETS
+		| NV_IPFIX_DATA_FIELD_RESPONDER_OCTETS
+		| NV_IPFIX_DATA_FIELD_FLOW_COUNT;
+
+static const nvIPFIX_export_sum_by_key_t SumByKeys[] = {
+		{ "vlan", "vlanId" },
+		{ "vxlan", "layer2SegmentId" },
+		{ "client-switch-port", "ingressInterface" },
+		{ "server-switch-port", "egressInterface" },
+		{ "ether-type", "ethernetType" },
+		{ "client-mac", "sourceMacAddress" },
+		{ "server-mac", "destinationMacAddress" },
+		{ "client-ip", "sourceIPv4Address" },
+		{ "server-ip", "destinationIPv4Address" },
+		{ "client-port", "sourceTransportPort" },
+		{ "server-port", "destinationTransportPort" },
+		{ "proto", "protocolIdentifier" }
+};
+
+static const size_t SumByKeysCount = (sizeof SumByKeys) / sizeof (nvIPFIX_export_sum_by_key_t);
+
 static fbInfoElementSpec_t StatsTemplate[] = {
 		NVIPFIX_TEMPLATE_ITEM( "exportedMessageTotalCount" ),
 		NVIPFIX_TEMPLATE_ITEM( "exportedFlowRecordTotalCount" ),
@@ -119,8 +196,11 @@ static fbInfoElementSpec_t StatsTemplate[] = {
 
 static fbInfoModel_t * InfoModel = NULL;
 
-static bool nvipfix_export_init( void );
 static void nvipfix_export_cleanup( void );
+static uint32_t nvipfix_export_get_template_flags( const nvIPFIX_CHAR * );
+static uint32_t nvipfix_export_get_aggregated_template_flags( const nvIPFIX_CHAR * );
+static uint32_t nvipfix_export_get_template_flags_of_record_fields( nvIPFIX_U32 );
+static size_t nvipfix_export_get_template_index( const char *, size_t );
 
 
 #pragma GCC diagnostic push
@@ -129,6 +209,10 @@ bool nvipfix_export_init( void )
 {
 	static volatile bool isInitialized = false;
 
+	if (isInitialized) {
+		return true;
+	}
+
 	#pragma omp critical (nvipfixCritical_ExportInit)
 	{
 		if (!isInitialized) {
@@ -147,6 +231,10 @@ bool nvipfix_export_init( void )
 
 			fbInfoModelAddElement( InfoModel, &ieLatency );
 
+			for (size_t i = 0; i < TemplateCount; i++) {
+				Template[i].flags = NVIPFIX_TEMPLATE_FLAG( i );
+			}
+
 			atexit( nvipfix_export_cleanup );
 			isInitialized = true;
 
@@ -190,14 +278,147 @@ void nvipfix_export_cleanup( void )
 	}
 }
 
+/**
+ * template flags of the IEs listed in a collector's export-fields
+ * @param a_exportFields comma separated IE names, NULL for all
+ * @return
+ */
+uint32_t nvipfix_export_get_template_flags( const nvIPFIX_CHAR * a_exportFields )
+{
+	uint32_t result = 0;
+	const nvIPFIX_CHAR * s = a_exportFields;
+
+	if (a_exportFields == NULL) {
+		return UINT32_MAX;
+	}
+
+	while (*s != '\0') {
+		size_t len = strcspn( s, "," );
+		size_t i = nvipfix_export_get_template_index( s, len );
+
+		if (i < TemplateCount) {
+			result |= NVIPFIX_TEMPLATE_FLAG( i );
+		}
+		else if (len > 0) {
+			nvipfix_log_warning( "%s: unknown export field '%.*s'", __func__, (int)len, s );
+		}
+
+		s += (s[len] == ',') ? len + 1 : len;
+	}
+
+	return result;
+}
+
+/**
+ * template flags of an aggregated record: the IEs of the sum-by keys, the flow times and the counters
+ * @param a_sumBy comma separated sum-by keys
+ * @return
+ */
+uint32_t nvipfix_export_get_aggregated_template_flags( const nvIPFIX_CHAR * a_sumBy )
+{
+	uint32_t result = nvipfix_export_get_template_flags_of_record_fields( AggregatedRecordFields );
+	const nvIPFIX_CHAR * s = a_sumBy;
+
+	while (*s != '\0') {
+		size_t len = strcspn( s, "," );
+		size_t i = 0;
+
+		while (i < SumByKeysCount && !(strlen( SumByKeys[i].key ) == len && strncmp( SumByKeys[i].key, s, len ) == 0)) {
+			i++;
+		}
+
+		if (i < SumByKeysCount) {
+			result |= NVIPFIX_TEMPLATE_FLAG( nvipfix_export_get_template_index( SumByKeys[i].name,
+					strlen( SumByKeys[i].name ) ) );
+		}
+		else if (len > 0) {
+			nvipfix_log_warning( "%s: sum-by key '%.*s' has no IE, it is not exported", __func__, (int)len, s );
+		}
+
+		s += (s[len] == ',') ? len + 1 : len;
+	}
+
+	return result;
+}
+
+uint32_t nvipfix_export_get_template_flags_of_record_fields( nvIPFIX_U32 a_fields )
+{
+	uint32_t result = 0;
+
+	for (size_t i = 0; i < TemplateCount; i++) {
+		if ((TemplateRecordFields[i] & a_fields) != 0) {
+			result |= NVIPFIX_TEMPLATE_FLAG( i );
+		}
+	}
+
+	return result;
+}
+
+/**
+ *
+ * @param a_name
+ * @param a_len
+ * @return TemplateCount if there is no such IE
+ */
+size_t nvipfix_export_get_template_index( const char * a_name, size_t a_len )
+{
+	size_t i = 0;
+
+	while (i < TemplateCount && !(strlen( Template[i].name ) == a_len && strncmp( Template[i].name, a_name, a_len ) == 0)) {
+		i++;
+	}
+
+	return i;
+}
+
+nvIPFIX_U32 nvipfix_export_get_record_fields( const nvIPFIX_CHAR * a_exportFields )
+{
+	nvIPFIX_U32 result = 0;
+	uint32_t flags = nvipfix_export_get_template_flags( a_exportFields );
+
+	for (size_t i = 0; i < TemplateCount; i++) {
+		if ((flags & NVIPFIX_TEMPLATE_FLAG( i )) != 0) {
+			result |= TemplateRecordFields[i];
+		}
+	}
+
+	return result;
+}
+
 nvIPFIX_error_t nvipfix_export(
 		const nvIPFIX_CHAR * a_host,
 		const nvIPFIX_CHAR * a_port,
 		nvIPFIX_TRANSPORT a_transport,
+		const nvIPFIX_CHAR * a_exportFields,
+		const nvIPFIX_CHAR * a_sumBy,
 		const nvIPFIX_data_record_list_t * a_data,
 		const nvIPFIX_datetime_t * a_startTs,
 		const nvIPFIX_datetime_t * a_endTs,
 		void **ptr )
+{
+	nvIPFIX_error_t error = nvipfix_export_begin( a_host, a_port, a_transport, a_exportFields, a_sumBy,
+			a_startTs, a_endTs, ptr );
+
+	if (error.code == NV_IPFIX_ERROR_CODE_NONE) {
+		for (const nvIPFIX_data_record_t * record = a_data->head; record != NULL; record = record->next) {
+			nvipfix_export_append( *ptr, record );
+		}
+
+		error = nvipfix_export_end( *ptr );
+	}
+
+	return error;
+}
+
+nvIPFIX_error_t nvipfix_export_begin(
+		const nvIPFIX_CHAR * a_host,
+		const nvIPFIX_CHAR * a_port,
+		nvIPFIX_TRANSPORT a_transport,
+		const nvIPFIX_CHAR * a_exportFields,
+		const nvIPFIX_CHAR * a_sumBy,
+		const nvIPFIX_datetime_t * a_startTs,
+		const nvIPFIX_datetime_t * a_endTs,
+		void **ptr )
 {
 	nvIPFIX_collector_t * collector = NULL;
 	fbSession_t * session;
@@ -272,9 +493,25 @@ nvIPFIX_error_t nvipfix_export(
 			error, NV_IPFIX_ERROR_CODE_EXPORT_TEMPLATE_APPEND_SPEC, StatsTemplateAppendSpec,
 			"%s", "Stats template append spec failed" );
 
+		/*
+		 * records are appended in the full internal template, fixbuf drops the IEs
+		 * the collector's export template leaves out (deltaFlowCount is for aggregated records only)
+		 */
+		priv->exportFlags = nvipfix_export_get_template_flags( a_exportFields );
+
+		fbTemplate_t * exportTemplate = fbTemplateAlloc( InfoModel );
+		NVIPFIX_ERROR_RAISE_IF( exportTemplate == NULL, error, NV_IPFIX_ERROR_CODE_ALLOCATE_TEMPLATE,
+			ExportTemplateAlloc, "%s", "Export template alloc failed" );
+
+		NVIPFIX_ERROR_RAISE_IF( !fbTemplateAppendSpecArray( exportTemplate, Template,
+				priv->exportFlags & ~nvipfix_export_get_template_flags_of_record_fields( NV_IPFIX_DATA_FIELD_FLOW_COUNT ),
+				&fbError ),
+			error, NV_IPFIX_ERROR_CODE_EXPORT_TEMPLATE_APPEND_SPEC, ExportTemplateAppendSpec,
+			"%s", "Export template append spec failed" );
+
 		NVIPFIX_ERROR_RAISE_IF(
 			(templateId = fbSessionAddTemplate( session, TRUE, NVIPFIX_FLOW_TID, template, &fbError )) == 0
-			|| (templateIdExt = fbSessionAddTemplate( session, FALSE, NVIPFIX_FLOW_TID, template, &fbError )) == 0,
+			|| (templateIdExt = fbSessionAddTemplate( session, FALSE, NVIPFIX_FLOW_TID, exportTemplate, &fbError )) == 0,
 			error, NV_IPFIX_ERROR_CODE_EXPORT_SESSION_ADD_TEMPLATE, SessionAddTemplate,
 			"%s", "Session add template failed" );
 
@@ -302,8 +539,23 @@ nvIPFIX_error_t nvipfix_export(
 	session = priv->session;
 	templateId = priv->templateId;
 	templateIdExt = priv->templateIdExt;
-	statsTemplateId = priv->statsTemplateId;
-	statsTemplateIdExt = priv->statsTemplateIdExt;
+
+	if (a_sumBy != NULL && priv->templateIdAggregated == 0) {
+		fbTemplate_t * aggregatedTemplate = fbTemplateAlloc( InfoModel );
+		NVIPFIX_ERROR_RAISE_IF( aggregatedTemplate == NULL, error, NV_IPFIX_ERROR_CODE_ALLOCATE_TEMPLATE,
+			AggregatedTemplate, "%s", "Aggregated template alloc failed" );
+
+		NVIPFIX_ERROR_RAISE_IF( !fbTemplateAppendSpecArray( aggregatedTemplate, Template,
+				priv->exportFlags & nvipfix_export_get_aggregated_template_flags( a_sumBy ), &fbError )
+			|| (priv->templateIdAggregated = fbSessionAddTemplate( session, FALSE, NVIPFIX_AGGREGATED_TID,
+					aggregatedTemplate, &fbError )) == 0,
+			error, NV_IPFIX_ERROR_CODE_EXPORT_TEMPLATE_APPEND_SPEC, AggregatedTemplate,
+			"%s", "Aggregated template failed" );
+	}
+
+	if (a_sumBy != NULL) {
+		templateIdExt = priv->templateIdAggregated;
+	}
 
 	NVIPFIX_ERROR_RAISE_IF( !fbSessionExportTemplates( session, NULL ),
 			error, NV_IPFIX_ERROR_CODE_EXPORT_SESSION_EXPORT_TEMPLATES, SessionExportTemplates,
@@ -317,83 +569,154 @@ nvIPFIX_error_t nvipfix_export(
 			error, NV_IPFIX_ERROR_CODE_EXPORT_SET_EXPORT_TEMPLATE, SetExportTemplate,
 			"%s", "Set export template failed" );
 
-	nvIPFIX_U32 startTs = nvipfix_datetime_get_seconds_since_epoch( a_startTs, 1970, 1 );
-	nvIPFIX_U32 endTs = nvipfix_datetime_get_seconds_since_epoch( a_endTs, 1970, 1 );
-
-	nvIPFIX_data_record_t * record = a_data->head;
-	int recordCount = 0;
-
-	while (record != NULL) {
-		nvIPFIX_export_data_t data = { 0 };
-
-		data.flowStartSeconds = record->flowStart.hasValue
-				? nvipfix_datetime_get_seconds_since_epoch( &(record->flowStart), 1970, 1 )
-						: startTs;
-
-		data.flowEndSeconds = record->flowEnd.hasValue
-				? nvipfix_datetime_get_seconds_since_epoch( &(record->flowEnd), 1970, 1 )
-						: endTs;
-
-		data.flowDurationMilliseconds = nvipfix_timespan_get_milliseconds( &record->flowDuration );
-		data.ingressInterface = record->ingressInterface;
-		data.egressInterface = record->egressInterface;
-		data.vlanId = record->vlanId;
-		data.layer2SegmentId = record->layer2SegmentId;
-		data.transportOctetDeltaCount = record->transportOctetDeltaCount;
-		data.initiatorOctets = record->initiatorOctets;
-		data.responderOctets = record->responderOctets;
-		data.sourceIpAddress = record->sourceIp.value;
-		data.destinationIpAddress = record->destinationIp.value;
-		data.sourceTransportPort = record->sourcePort;
-		data.destinationTransportPort = record->destinationPort;
-		memcpy( data.sourceMacAddress, record->sourceMac.octets, sizeof data.sourceMacAddress );
-		memcpy( data.destinationMacAddress, record->destinationMac.octets, sizeof data.destinationMacAddress );
-		data.protocolIdentifier = record->protocol;
-		data.tcpControlBits = (uint8_t) record->tcpControlBits;
-		data.ethernetType = (uint16_t) record->ethernetType;
-		data.latencyMicroseconds = nvipfix_timespan_get_microseconds( &record->latency );
-
-		NVIPFIX_TLOG_TRACE(
-				"%d.%d.%d.%d:%d -> %d.%d.%d.%d:%d %d %d-%d %d %02x:%02x:%02x:%02x:%02x:%02x",
-				NVIPFIX_ARGSF_IP_ADDRESS( record->sourceIp ),
-				(unsigned)record->sourcePort,
-				NVIPFIX_ARGSF_IP_ADDRESS( record->destinationIp ),
-				(unsigned)record->destinationPort, (unsigned)record->transportOctetDeltaCount,
-				(unsigned)data.flowStartSeconds, (unsigned)data.flowEndSeconds,
-				(unsigned)data.flowDurationMilliseconds,
-				NVIPFIX_ARGSF_MAC_ADDRESS( record->sourceMac ));
-
-		if (!fBufAppend( buffer, (uint8_t *) &data, sizeof (nvIPFIX_export_data_t), &fbError )) {
-			NVIPFIX_TLOG_ERROR( "%s: fBufAppend", __func__ );
-			g_clear_error( &fbError );
-		}
-		else {
-			recordCount++;
-		}
+	priv->startTs = nvipfix_datetime_get_seconds_since_epoch( a_startTs, 1970, 1 );
+	priv->endTs = nvipfix_datetime_get_seconds_since_epoch( a_endTs, 1970, 1 );
+	priv->recordCount = 0;
+
+	return error;
 
-		record = record->next;
+	/*
+	 * These are error return paths.
+	 */
+	NVIPFIX_ERROR_HANDLER( SetExportTemplate );
+
+	NVIPFIX_ERROR_HANDLER( SetInternalTemplate );
+
+	NVIPFIX_ERROR_HANDLER( SessionExportTemplates );
+
+	NVIPFIX_ERROR_HANDLER( AggregatedTemplate );
+
+	fBufFree( buffer );
+
+	NVIPFIX_ERROR_HANDLER( BufAlloc );
+
+	NVIPFIX_ERROR_HANDLER( SessionAddTemplate );
+
+	NVIPFIX_ERROR_HANDLER( ExportTemplateAppendSpec );
+
+	NVIPFIX_ERROR_HANDLER( ExportTemplateAlloc );
+
+	NVIPFIX_ERROR_HANDLER( StatsTemplateAppendSpec );
+
+	NVIPFIX_ERROR_HANDLER( TemplateAppendSpec );
+
+	NVIPFIX_ERROR_HANDLER( StatsTemplateAlloc );
+
+	NVIPFIX_ERROR_HANDLER( TemplateAlloc );
+
+	NVIPFIX_ERROR_HANDLER( ExporterAlloc );
+
+	NVIPFIX_ERROR_HANDLER( SessionAlloc );
+
+	if (priv != NULL)
+		free(priv);
+	if (collector != NULL)
+		free(collector);
+
+	*ptr = NULL;
+
+	NVIPFIX_ERROR_HANDLER( CollectorAlloc );
+
+	NVIPFIX_ERROR_HANDLER( Init );
+
+	g_clear_error( &fbError );
+
+	return error;
+}
+
+bool nvipfix_export_append( void * a_ctx, const nvIPFIX_data_record_t * a_record )
+{
+	nvIPFIX_collector_private_t * priv = a_ctx;
+	GError * fbError = NULL;
+
+	if (priv == NULL) {
+		return false;
 	}
 
+	nvIPFIX_export_data_t data = { 0 };
+
+	data.flowStartSeconds = a_record->flowStart.hasValue
+			? nvipfix_datetime_get_seconds_since_epoch( &(a_record->flowStart), 1970, 1 )
+					: priv->startTs;
+
+	data.flowEndSeconds = a_record->flowEnd.hasValue
+			? nvipfix_datetime_get_seconds_since_epoch( &(a_record->flowEnd), 1970, 1 )
+					: priv->endTs;
+
+	data.flowDurationMilliseconds = nvipfix_timespan_get_milliseconds( &a_record->flowDuration );
+	data.ingressInterface = a_record->ingressInterface;
+	data.egressInterface = a_record->egressInterface;
+	data.vlanId = a_record->vlanId;
+	data.layer2SegmentId = a_record->layer2SegmentId;
+	data.transportOctetDeltaCount = a_record->transportOctetDeltaCount;
+	data.initiatorOctets = a_record->initiatorOctets;
+	data.responderOctets = a_record->responderOctets;
+	data.deltaFlowCount = a_record->flowCount;
+	data.sourceIpAddress = a_record->sourceIp.value;
+	data.destinationIpAddress = a_record->destinationIp.value;
+	data.sourceTransportPort = a_record->sourcePort;
+	data.destinationTransportPort = a_record->destinationPort;
+	memcpy( data.sourceMacAddress, a_record->sourceMac.octets, sizeof data.sourceMacAddress );
+	memcpy( data.destinationMacAddress, a_record->destinationMac.octets, sizeof data.destinationMacAddress );
+	data.protocolIdentifier = a_record->protocol;
+	data.tcpControlBits = (uint8_t) a_record->tcpControlBits;
+	data.ethernetType = (uint16_t) a_record->ethernetType;
+	data.latencyMicroseconds = nvipfix_timespan_get_microseconds( &a_record->latency );
+
+	NVIPFIX_TLOG_TRACE(
+			"%d.%d.%d.%d:%d -> %d.%d.%d.%d:%d %d %d-%d %d %02x:%02x:%02x:%02x:%02x:%02x",
+			NVIPFIX_ARGSF_IP_ADDRESS( a_record->sourceIp ),
+			(unsigned)a_record->sourcePort,
+			NVIPFIX_ARGSF_IP_ADDRESS( a_record->destinationIp ),
+			(unsigned)a_record->destinationPort, (unsigned)a_record->transportOctetDeltaCount,
+			(unsigned)data.flowStartSeconds, (unsigned)data.flowEndSeconds,
+			(unsigned)data.flowDurationMilliseconds,
+			NVIPFIX_ARGSF_MAC_ADDRESS( a_record->sourceMac ));
+
+	if (!fBufAppend( priv->buffer, (uint8_t *) &data, sizeof (nvIPFIX_export_data_t), &fbError )) {
+		NVIPFIX_TLOG_ERROR( "%s: fBufAppend", __func__ );
+		g_clear_error( &fbError );
+
+		return false;
+	}
+
+	priv->recordCount++;
+
+	return true;
+}
+
+nvIPFIX_error_t nvipfix_export_end( void * a_ctx )
+{
+	nvIPFIX_collector_private_t * priv = a_ctx;
+	GError * fbError = NULL;
+
+	NVIPFIX_ERROR_INIT( error );
+
+	NVIPFIX_ERROR_RAISE_IF( priv == NULL, error, NV_IPFIX_ERROR_CODE_INVALID_ARGUMENTS, Args, "", NULL );
+
+	nvIPFIX_collector_t * collector = priv->collector;
+	fBuf_t * buffer = priv->buffer;
+
 	if (!fBufEmit(buffer, &fbError)) {
 		NVIPFIX_TLOG_ERROR( "fBufEmit: %s\n", fbError->message );
 		g_clear_error( &fbError );
 	}
 
-	if (!fBufSetInternalTemplate( buffer, statsTemplateId, &fbError )) {
+	if (!fBufSetInternalTemplate( buffer, priv->statsTemplateId, &fbError )) {
 		NVIPFIX_TLOG_ERROR( "Set internal template (stats) failed: %s", fbError->message );
 		error.code = NV_IPFIX_ERROR_CODE_EXPORT_SET_INTERNAL_TEMPLATE;
 		g_clear_error( &fbError );
 		goto errorSetInternalTemplateStats;
 	}
 
-	if (!fBufSetExportTemplate( buffer, statsTemplateIdExt, &fbError )) {
+	if (!fBufSetExportTemplate( buffer, priv->statsTemplateIdExt, &fbError )) {
 		NVIPFIX_TLOG_ERROR( "Set export template (stats) failed: %s", fbError->message );
 		error.code = NV_IPFIX_ERROR_CODE_EXPORT_SET_EXPORT_TEMPLATE;
 		g_clear_error( &fbError );
 		goto errorSetExportTemplateStats;
 	}
 
-	collector->flowRecordCount += recordCount;
+	collector->flowRecordCount += priv->recordCount;
 	collector->messageCount++;
 
 	nvIPFIX_export_stats_data_t stats = { 0 };
@@ -412,47 +735,11 @@ nvIPFIX_error_t nvipfix_export(
 
 	return error;
 
-	/*
-	 * These are error return paths.
-	 */
 	NVIPFIX_ERROR_HANDLER( SetExportTemplateStats );
 
 	NVIPFIX_ERROR_HANDLER( SetInternalTemplateStats );
 
-	NVIPFIX_ERROR_HANDLER( SetExportTemplate );
-
-	NVIPFIX_ERROR_HANDLER( SetInternalTemplate );
-
-	NVIPFIX_ERROR_HANDLER( SessionExportTemplates );
-
-	fBufFree( buffer );
-
-	NVIPFIX_ERROR_HANDLER( BufAlloc );
-
-	NVIPFIX_ERROR_HANDLER( SessionAddTemplate );
-
-	NVIPFIX_ERROR_HANDLER( StatsTemplateAppendSpec );
-
-	NVIPFIX_ERROR_HANDLER( TemplateAppendSpec );
-
-	NVIPFIX_ERROR_HANDLER( StatsTemplateAlloc );
-
-	NVIPFIX_ERROR_HANDLER( TemplateAlloc );
-
-	NVIPFIX_ERROR_HANDLER( ExporterAlloc );
-
-	NVIPFIX_ERROR_HANDLER( SessionAlloc );
-
-	if (priv != NULL)
-		free(priv);
-	if (collector != NULL)
-		free(collector);
-
-	NVIPFIX_ERROR_HANDLER( CollectorAlloc );
-
-	NVIPFIX_ERROR_HANDLER( Init );
-
-	g_clear_error( &fbError );
+	NVIPFIX_ERROR_HANDLER( Args );
 
 	return error;
 }
@@ -0,0 +1,411 @@
+/**
+ * This file is part of nvIPFIX
+ * Copyright (C) 2015 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * nvIPFIX is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "include/types.h"
+#include "include/log.h"
+#include "include/data.h"
+
+#include "include/flowcache.h"
+
+
+/*
+ * flows live in a pool of fixed-size entries and are found through an open addressing
+ * index of (hash, entry) slots, probed linearly: a lookup touches one or two cache lines
+ * of the index and then the entry. Entries never move, the idle timer wheel links them by
+ * position. Positions are stored plus one, 0 stands for none
+ */
+
+enum {
+	FlowCacheLoadFactor = 2,		//!< index slots per flow
+	FlowCacheCapacityMax = 1U << 30
+};
+
+
+typedef struct {
+	uint32_t sourceIp;
+	uint32_t destinationIp;
+	uint32_t layer2SegmentId;
+	uint16_t sourcePort;
+	uint16_t destinationPort;
+	uint16_t vlanId;
+	uint8_t protocol;
+	uint8_t reserved;				//!< always 0, keys are compared with memcmp
+} nvIPFIX_flowcache_key_t;
+
+typedef struct {
+	nvIPFIX_flowcache_key_t key;
+	uint32_t expiry;				//!< seconds since epoch
+	uint64_t transportOctetDeltaCount;
+	uint64_t initiatorOctets;
+	uint64_t responderOctets;
+	uint32_t next;					//!< timer wheel slot list, or free list
+	uint32_t prev;
+	uint32_t lastExport;			//!< seconds since epoch
+	uint32_t isEnded;				//!< the flow's end was exported
+} nvIPFIX_flowcache_entry_t;
+
+typedef struct {
+	uint32_t hash;
+	uint32_t entry;
+} nvIPFIX_flowcache_slot_t;
+
+struct _nvIPFIX_flowcache_t {
+	nvIPFIX_flowcache_entry_t * entries;
+	nvIPFIX_flowcache_slot_t * slots;
+	uint32_t * wheel;				//!< flows by expiry second, modulo the wheel size
+	size_t capacity;
+	size_t count;
+	size_t slotsMask;
+	size_t wheelMask;
+	uint32_t freeEntry;
+	uint32_t usedCount;				//!< entries ever taken from the pool
+	unsigned idleTimeout;
+	unsigned activeTimeout;
+	time_t lastExpiry;
+	unsigned long overflowsCount;	//!< flows not cached because the cache was full
+};
+
+
+static inline void nvipfix_flowcache_get_key( nvIPFIX_flowcache_key_t *, const nvIPFIX_data_record_t * );
+static inline uint32_t nvipfix_flowcache_hash( const nvIPFIX_flowcache_key_t * );
+static inline void nvipfix_flowcache_link( nvIPFIX_flowcache_t *, uint32_t );
+static inline void nvipfix_flowcache_unlink( nvIPFIX_flowcache_t *, uint32_t );
+static void nvipfix_flowcache_remove( nvIPFIX_flowcache_t *, uint32_t );
+static size_t nvipfix_flowcache_get_power_of_2( size_t );
+
+
+nvIPFIX_flowcache_t * nvipfix_flowcache_create( size_t a_capacity, unsigned a_idleTimeout, unsigned a_activeTimeout )
+{
+	nvIPFIX_flowcache_t * result = calloc( 1, sizeof (nvIPFIX_flowcache_t) );
+
+	if (result == NULL || a_capacity == 0 || a_capacity > FlowCacheCapacityMax) {
+		nvipfix_log_error( "%s: invalid capacity or memory allocation failed, capacity = %zu", __func__, a_capacity );
+		free( result );
+
+		return NULL;
+	}
+
+	size_t slotsCount = nvipfix_flowcache_get_power_of_2( a_capacity * FlowCacheLoadFactor );
+	size_t wheelSize = nvipfix_flowcache_get_power_of_2( (size_t)a_idleTimeout + 1 );
+
+	result->capacity = a_capacity;
+	result->slotsMask = slotsCount - 1;
+	result->wheelMask = wheelSize - 1;
+	result->idleTimeout = a_idleTimeout;
+	result->activeTimeout = a_activeTimeout;
+
+	/*
+	 * pages of the pool are touched only as flows arrive
+	 */
+	result->entries = malloc( a_capacity * sizeof (nvIPFIX_flowcache_entry_t) );
+	result->slots = calloc( slotsCount, sizeof (nvIPFIX_flowcache_slot_t) );
+	result->wheel = calloc( wheelSize, sizeof (uint32_t) );
+
+	if (result->entries == NULL || result->slots == NULL || result->wheel == NULL) {
+		nvipfix_log_error( "%s: memory allocation failed, capacity = %zu", __func__, a_capacity );
+		nvipfix_flowcache_free( result );
+
+		return NULL;
+	}
+
+	NVIPFIX_LOG_DEBUG( "capacity = %zu, index slots = %zu, wheel size = %zu", a_capacity, slotsCount, wheelSize );
+
+	return result;
+}
+
+void nvipfix_flowcache_free( nvIPFIX_flowcache_t * a_cache )
+{
+	NVIPFIX_NULL_ARGS_GUARD_1_VOID( a_cache );
+
+	free( a_cache->entries );
+	free( a_cache->slots );
+	free( a_cache->wheel );
+	free( a_cache );
+}
+
+bool nvipfix_flowcache_update( nvIPFIX_flowcache_t * a_cache, nvIPFIX_data_record_t * a_record, time_t a_now )
+{
+	NVIPFIX_NULL_ARGS_GUARD_2( a_cache, a_record, true );
+
+	nvIPFIX_flowcache_key_t key;
+	nvipfix_flowcache_get_key( &key, a_record );
+
+	uint32_t hash = nvipfix_flowcache_hash( &key );
+	size_t i = hash & a_cache->slotsMask;
+
+	while (a_cache->slots[i].entry != 0) {
+		if (a_cache->slots[i].hash == hash
+				&& memcmp( &(a_cache->entries[a_cache->slots[i].entry - 1].key), &key, sizeof key ) == 0) {
+			break;
+		}
+
+		i = (i + 1) & a_cache->slotsMask;
+	}
+
+	uint32_t position = a_cache->slots[i].entry;
+	nvIPFIX_flowcache_entry_t * entry;
+	bool isEnd = a_record->transition == NV_IPFIX_FLOW_TRANSITION_ENDED
+			|| a_record->transition == NV_IPFIX_FLOW_TRANSITION_STARTED_AND_ENDED;
+	bool result = true;
+
+	if (position != 0) {
+		entry = a_cache->entries + position - 1;
+		nvipfix_flowcache_unlink( a_cache, position );
+
+		/*
+		 * counters going down belong to a new connection with the same key
+		 */
+		uint64_t octets = a_record->transportOctetDeltaCount;
+		uint64_t initiatorOctets = a_record->initiatorOctets;
+		uint64_t responderOctets = a_record->responderOctets;
+
+		if (octets >= entry->transportOctetDeltaCount && initiatorOctets >= entry->initiatorOctets
+				&& responderOctets >= entry->responderOctets) {
+			a_record->transportOctetDeltaCount -= entry->transportOctetDeltaCount;
+			a_record->initiatorOctets -= entry->initiatorOctets;
+			a_record->responderOctets -= entry->responderOctets;
+		}
+
+		/*
+		 * an end is exported once, an unchanged running flow when the active timeout passes
+		 */
+		result = a_record->transportOctetDeltaCount != 0 || a_record->initiatorOctets != 0
+				|| a_record->responderOctets != 0
+				|| (isEnd && !entry->isEnded)
+				|| (a_cache->activeTimeout != 0 && !entry->isEnded
+						&& (uint32_t)a_now - entry->lastExport >= a_cache->activeTimeout);
+
+		entry->transportOctetDeltaCount = octets;
+		entry->initiatorOctets = initiatorOctets;
+		entry->responderOctets = responderOctets;
+	}
+	else if (a_cache->count < a_cache->capacity) {
+		if (a_cache->freeEntry != 0) {
+			position = a_cache->freeEntry;
+			a_cache->freeEntry = a_cache->entries[position - 1].next;
+		}
+		else {
+			position = ++a_cache->usedCount;
+		}
+
+		entry = a_cache->entries + position - 1;
+		entry->key = key;
+		entry->transportOctetDeltaCount = a_record->transportOctetDeltaCount;
+		entry->initiatorOctets = a_record->initiatorOctets;
+		entry->responderOctets = a_record->responderOctets;
+
+		a_cache->slots[i].hash = hash;
+		a_cache->slots[i].entry = position;
+		a_cache->count++;
+	}
+	else {
+		if (a_cache->overflowsCount++ == 0) {
+			nvipfix_log_warning( "%s: flow cache full (%zu flows), new flows are exported with their total counters",
+					__func__, a_cache->capacity );
+		}
+
+		return true;
+	}
+
+	if (result) {
+		entry->lastExport = (uint32_t)a_now;
+		entry->isEnded = isEnd;
+	}
+
+	/*
+	 * an ended flow is kept for the idle timeout, repeated reports of its end are dropped
+	 */
+	entry->expiry = (uint32_t)(a_now + a_cache->idleTimeout);
+	nvipfix_flowcache_link( a_cache, position );
+
+	return result;
+}
+
+void nvipfix_flowcache_update_list( nvIPFIX_flowcache_t * a_cache, nvIPFIX_data_record_list_t * a_list, time_t a_now )
+{
+	NVIPFIX_NULL_ARGS_GUARD_2_VOID( a_cache, a_list );
+
+	nvIPFIX_data_record_t * record = a_list->head;
+
+	while (record != NULL) {
+		nvIPFIX_data_record_t * next = record->next;
+
+		if (!nvipfix_flowcache_update( a_cache, record, a_now )) {
+			nvipfix_data_list_remove( a_list, record );
+			free( record );
+		}
+
+		record = next;
+	}
+}
+
+size_t nvipfix_flowcache_expire( nvIPFIX_flowcache_t * a_cache, time_t a_now )
+{
+	NVIPFIX_NULL_ARGS_GUARD_1( a_cache, 0 );
+
+	size_t result = 0;
+	time_t tick = a_cache->lastExpiry + 1;
+
+	/*
+	 * one turn of the wheel visits every slot
+	 */
+	if (a_cache->lastExpiry == 0 || a_now - tick > (time_t)a_cache->wheelMask) {
+		tick = a_now - (time_t)a_cache->wheelMask;
+	}
+
+	for (; tick <= a_now; tick++) {
+		uint32_t position = a_cache->wheel[tick & a_cache->wheelMask];
+
+		while (position != 0) {
+			uint32_t next = a_cache->entries[position - 1].next;
+
+			if ((time_t)a_cache->entries[position - 1].expiry <= a_now) {
+				nvipfix_flowcache_remove( a_cache, position );
+				result++;
+			}
+
+			position = next;
+		}
+	}
+
+	a_cache->lastExpiry = a_now;
+	a_cache->overflowsCount = 0;
+
+	NVIPFIX_LOG_DEBUG( "%zu flow(s) expired, %zu cached", result, a_cache->count );
+
+	return result;
+}
+
+size_t nvipfix_flowcache_get_count( const nvIPFIX_flowcache_t * a_cache )
+{
+	NVIPFIX_NULL_ARGS_GUARD_1( a_cache, 0 );
+
+	return a_cache->count;
+}
+
+void nvipfix_flowcache_get_key( nvIPFIX_flowcache_key_t * a_key, const nvIPFIX_data_record_t * a_record )
+{
+	a_key->sourceIp = a_record->sourceIp.value;
+	a_key->destinationIp = a_record->destinationIp.value;
+	a_key->layer2SegmentId = (uint32_t)a_record->layer2SegmentId;
+	a_key->sourcePort = a_record->sourcePort;
+	a_key->destinationPort = a_record->destinationPort;
+	a_key->vlanId = a_record->vlanId;
+	a_key->protocol = (uint8_t)a_record->protocol;
+	a_key->reserved = 0;
+}
+
+uint32_t nvipfix_flowcache_hash( const nvIPFIX_flowcache_key_t * a_key )
+{
+	uint64_t a = ((uint64_t)a_key->sourceIp << 32) | a_key->destinationIp;
+	uint64_t b = ((uint64_t)a_key->sourcePort << 48) | ((uint64_t)a_key->destinationPort << 32)
+			| ((uint64_t)a_key->vlanId << 16) | a_key->protocol;
+	uint64_t h = (a ^ (b * 0x9E3779B97F4A7C15ULL) ^ ((uint64_t)a_key->layer2SegmentId << 7)) * 0xFF51AFD7ED558CCDULL;
+
+	h ^= h >> 33;
+	h *= 0xC4CEB9FE1A85EC53ULL;
+	h ^= h >> 29;
+
+	return (uint32_t)h;
+}
+
+void nvipfix_flowcache_link( nvIPFIX_flowcache_t * a_cache, uint32_t a_position )
+{
+	nvIPFIX_flowcache_entry_t * entry = a_cache->entries + a_position - 1;
+	uint32_t * head = a_cache->wheel + (entry->expiry & a_cache->wheelMask);
+
+	entry->prev = 0;
+	entry->next = *head;
+
+	if (*head != 0) {
+		a_cache->entries[*head - 1].prev = a_position;
+	}
+
+	*head = a_position;
+}
+
+void nvipfix_flowcache_unlink( nvIPFIX_flowcache_t * a_cache, uint32_t a_position )
+{
+	nvIPFIX_flowcache_entry_t * entry = a_cache->entries + a_position - 1;
+
+	if (entry->prev != 0) {
+		a_cache->entries[entry->prev - 1].next = entry->next;
+	}
+	else {
+		a_cache->wheel[entry->expiry & a_cache->wheelMask] = entry->next;
+	}
+
+	if (entry->next != 0) {
+		a_cache->entries[entry->next - 1].prev = entry->prev;
+	}
+}
+
+/**
+ * take a flow out of the wheel and the index, the slots after it are shifted back
+ * so that probing needs no tombstones
+ * @param a_cache
+ * @param a_position
+ */
+void nvipfix_flowcache_remove( nvIPFIX_flowcache_t * a_cache, uint32_t a_position )
+{
+	nvIPFIX_flowcache_entry_t * entry = a_cache->entries + a_position - 1;
+	size_t i = nvipfix_flowcache_hash( &(entry->key) ) & a_cache->slotsMask;
+
+	while (a_cache->slots[i].entry != a_position) {
+		i = (i + 1) & a_cache->slotsMask;
+	}
+
+	for (size_t j = (i + 1) & a_cache->slotsMask; a_cache->slots[j].entry != 0; j = (j + 1) & a_cache->slotsMask) {
+		size_t home = a_cache->slots[j].hash & a_cache->slotsMask;
+
+		/*
+		 * move the slot back unless its home lies cyclically in (i, j]
+		 */
+		if (((j - home) & a_cache->slotsMask) >= ((j - i) & a_cache->slotsMask)) {
+			a_cache->slots[i] = a_cache->slots[j];
+			i = j;
+		}
+	}
+
+	a_cache->slots[i].hash = 0;
+	a_cache->slots[i].entry = 0;
+
+	nvipfix_flowcache_unlink( a_cache, a_position );
+
+	entry->next = a_cache->freeEntry;
+	a_cache->freeEntry = a_position;
+	a_cache->count--;
+}
+
+size_t nvipfix_flowcache_get_power_of_2( size_t a_value )
+{
+	size_t result = 1;
+
+	while (result < a_value) {
+		result <<= 1;
+	}
+
+	return result;
+}
@@ -34,9 +34,59 @@
 
 #include "include/import.h"
 
+#ifdef NVIPFIX_DEF_POSIX
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined (NVIPFIX_DEF_POSIX) && (defined (NVIPFIX_DEF_ENABLE_ZLIB) || defined (NVIPFIX_DEF_ENABLE_ZSTD))
+#include <pthread.h>
+#include <signal.h>
+#include <errno.h>
+#define NVIPFIX_IMPORT_USE_DECOMPRESS
+#endif
+
+#if defined (NVIPFIX_DEF_POSIX) && defined (NVIPFIX_DEF_ENABLE_NVC)
+#include <pthread.h>
+#include <errno.h>
+#define NVIPFIX_IMPORT_USE_NVC_WATCHDOG
+#endif
+
+#ifdef NVIPFIX_DEF_ENABLE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef NVIPFIX_DEF_ENABLE_ZSTD
+#include <zstd.h>
+#endif
+
+#if defined (__x86_64__) || defined (__i386__)
+#ifdef __SSE2__
+#include <emmintrin.h>
+#define NVIPFIX_IMPORT_USE_SSE2
+#endif
+#if defined (__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#include <immintrin.h>
+#define NVIPFIX_IMPORT_USE_AVX2
+#endif
+#endif
+
 
-#define NVIPFIX_IMPORT_ITEM( a_name, a_field, a_parseValue ) { .name = a_name, \
-	.offset = offsetof( nvIPFIX_data_record_t, a_field ), .parseValue = a_parseValue }
+#define NVIPFIX_IMPORT_ITEM( a_name, a_field, a_dataField, a_parseValue ) { .name = a_name, .nameLen = (sizeof a_name) - 1, \
+	.offset = offsetof( nvIPFIX_data_record_t, a_field ), .dataField = a_dataField, .parseValue = a_parseValue }
+
+/*
+ * collision free for all Items[] names, verified when the index is built
+ */
+#define NVIPFIX_IMPORT_ITEM_HASH( a_name, a_len ) \
+	(((a_len) * 18 + (nvIPFIX_BYTE)(a_name)[0] + (nvIPFIX_BYTE)(a_name)[1]) & (SizeofItemsIndex - 1))
 
 #define NVIPFIX_NVC_GET_TCP_FLAGS_FROM_STATE( a_state ) ((a_state) == nvc_TCP_STATE_SYN ? NV_IPFIX_TCP_CONTROL_FLAG_SYN \
     : (a_state) == nvc_TCP_STATE_EST ? NV_IPFIX_TCP_CONTROL_FLAG_ACK \
@@ -44,6 +94,12 @@
     : (a_state) == nvc_TCP_STATE_RST ? NV_IPFIX_TCP_CONTROL_FLAG_RST \
     : NV_IPFIX_TCP_CONTROL_FLAG_NONE)        
 
+#define NVIPFIX_NVC_GET_FLOW_TRANSITION( a_trans ) ((a_trans) == nvc_CONN_TRANS_STARTED ? NV_IPFIX_FLOW_TRANSITION_STARTED \
+    : (a_trans) == nvc_CONN_TRANS_RUNNING ? NV_IPFIX_FLOW_TRANSITION_RUNNING \
+    : (a_trans) == nvc_CONN_TRANS_ENDED ? NV_IPFIX_FLOW_TRANSITION_ENDED \
+    : (a_trans) == nvc_CONN_TRANS_ST_AND_END ? NV_IPFIX_FLOW_TRANSITION_STARTED_AND_ENDED \
+    : NV_IPFIX_FLOW_TRANSITION_NONE)
+
 #define NVIPFIX_IN6_ADDR_TO_IP_ADDRESS( a_ipAddress, a_in6Addr ) \
 	(a_ipAddress).value = (*((uint8_t *)&(a_in6Addr) + 12)) << 24; \
 	(a_ipAddress).value |= (*((uint8_t *)&(a_in6Addr) + 13)) << 16; \
@@ -55,12 +111,99 @@
 	(a_macAddress).hasValue = true
 
 
+#define NVIPFIX_IMPORT_IS_WHITESPACE( a_ch ) ((a_ch) == ' ' || (a_ch) == '\t' || (a_ch) == '\r' || (a_ch) == '\n')
+
+
+enum {
+	SizeofShape = 32,
+	SizeofBlock = 64,
+	SizeofColumns = 64
+};
+
+
+typedef enum {
+	NV_IPFIX_IMPORT_STATUS_RECORD = 0,
+	NV_IPFIX_IMPORT_STATUS_END,
+	NV_IPFIX_IMPORT_STATUS_ERROR
+} nvIPFIX_IMPORT_STATUS;
+
+typedef enum {
+	NV_IPFIX_IMPORT_COMPRESSION_NONE = 0,
+	NV_IPFIX_IMPORT_COMPRESSION_GZIP,
+	NV_IPFIX_IMPORT_COMPRESSION_ZSTD
+} nvIPFIX_IMPORT_COMPRESSION;
+
 typedef struct {
 	const char * name;
+	size_t nameLen;
 	size_t offset;
+	nvIPFIX_DATA_FIELD dataField;
 	bool (* parseValue)( const char *, void * );
 } nvIPFIX_import_item_t;
 
+typedef struct {
+	const nvIPFIX_CHAR * value;
+	size_t len;
+} nvIPFIX_string_span_t;
+
+typedef struct {
+	const nvIPFIX_CHAR * cursor;
+	const nvIPFIX_CHAR * end;
+	const nvIPFIX_CHAR * record;	//!< start of the last record parse_records tried
+	const nvIPFIX_import_item_t * shape[SizeofShape];	//!< item resolved at each key position of the last record
+	const nvIPFIX_CHAR * block;		//!< start of the indexed block (SizeofBlock bytes)
+	uint64_t quoteBits;				//!< '"' positions in the block
+	uint64_t structuralBits;		//!< ':', ',', '{', '}', '[', ']' positions in the block
+	const nvIPFIX_import_item_t * columns[SizeofColumns];	//!< item of each column of delimited input (NULL if unknown)
+	size_t columnsCount;
+	nvIPFIX_CHAR delimiter;			//!< column delimiter of delimited input, '\0' for JSON input
+	bool isLast;					//!< the end of the buffer is the end of the input
+	nvIPFIX_U32 fields;				//!< nvIPFIX_DATA_FIELD flags of the fields to parse
+	bool isQuiet;					//!< count item warnings instead of logging them
+	size_t warningsCount;
+	bool isRowRejected;				//!< the last row of delimited input had an invalid value
+} nvIPFIX_import_parser_t;
+
+typedef struct {
+	const nvIPFIX_CHAR * start;		//!< first record of the chunk
+	const nvIPFIX_CHAR * cursor;	//!< where parsing of the chunk stopped
+	nvIPFIX_IMPORT_STATUS status;
+	nvIPFIX_data_record_list_t * list;
+	size_t count;
+	size_t warningsCount;			//!< item warnings held back while the chunk start was a guess
+} nvIPFIX_import_chunk_t;
+
+#ifdef NVIPFIX_IMPORT_USE_DECOMPRESS
+typedef struct {
+	FILE * file;					//!< compressed input
+	int fd;							//!< write end of the pipe the stream reads from
+	nvIPFIX_IMPORT_COMPRESSION compression;
+	nvIPFIX_BYTE * in;				//!< SizeofDecompressBuffer bytes, starts with the magic read by stream_open
+	size_t inLen;
+	nvIPFIX_BYTE * out;				//!< SizeofDecompressBuffer bytes
+	pthread_t thread;
+	bool isStarted;
+} nvIPFIX_import_decompressor_t;
+#endif
+
+struct _nvIPFIX_import_stream_t {
+	FILE * file;					//!< input or, for compressed input, read end of the decompressor pipe
+	nvIPFIX_CHAR * window;			//!< unparsed input is moved to the front on refill
+	size_t windowSize;
+	size_t len;						//!< bytes in the window
+	size_t offset;					//!< input offset of the window
+	size_t recordSize;				//!< average bytes per record seen so far
+	bool isEof;
+	bool isInRecords;				//!< "data" array found
+	bool isDone;
+	nvIPFIX_import_parser_t parser;
+#ifdef NVIPFIX_IMPORT_USE_DECOMPRESS
+	nvIPFIX_import_decompressor_t decompressor;
+#endif
+};
+
+typedef void (* nvIPFIX_import_index_block_ft)( const nvIPFIX_CHAR *, uint64_t *, uint64_t * );
+
 
 static bool nvipfix_import_parse_ingress( const char *, void * );
 static bool nvipfix_import_parse_egress( const char *, void * );
@@ -69,54 +212,127 @@ static bool nvipfix_import_parse_tcp_control_flags( const char *, void * );
 static bool nvipfix_import_parse_protocol( const char *, void * );
 static bool nvipfix_import_parse_ethernet_type( const char *, void * );
 
-static const nvIPFIX_import_item_t * nvipfix_import_get_item( const char * );
+static const nvIPFIX_import_item_t * nvipfix_import_get_item( const nvIPFIX_string_span_t * );
+
+#ifdef NVIPFIX_DEF_POSIX
+static void * nvipfix_import_map_file( const nvIPFIX_CHAR *, size_t * );
+#endif
+
+#ifdef NVIPFIX_IMPORT_USE_SSE2
+static void nvipfix_import_index_block_sse2( const nvIPFIX_CHAR *, uint64_t *, uint64_t * );
+#else
+static void nvipfix_import_index_block( const nvIPFIX_CHAR *, uint64_t *, uint64_t * );
+#endif
+#ifdef NVIPFIX_IMPORT_USE_AVX2
+static void nvipfix_import_index_block_avx2( const nvIPFIX_CHAR *, uint64_t *, uint64_t * )
+		__attribute__ ((target ("avx2")));
+#endif
+static const nvIPFIX_CHAR * nvipfix_import_scan( nvIPFIX_import_parser_t *, const nvIPFIX_CHAR *, bool );
+static const nvIPFIX_CHAR * nvipfix_import_scan_quote( nvIPFIX_import_parser_t *, const nvIPFIX_CHAR * );
+
+static const nvIPFIX_CHAR * nvipfix_import_skip_whitespace( const nvIPFIX_CHAR *, const nvIPFIX_CHAR * );
+static const nvIPFIX_CHAR * nvipfix_import_find_quote( const nvIPFIX_CHAR *, const nvIPFIX_CHAR * );
+static const nvIPFIX_CHAR * nvipfix_import_skip_nested( const nvIPFIX_CHAR *, const nvIPFIX_CHAR * );
+static const nvIPFIX_CHAR * nvipfix_import_skip_separators( const nvIPFIX_CHAR *, const nvIPFIX_CHAR * );
+static const nvIPFIX_CHAR * nvipfix_import_skip_newlines( const nvIPFIX_CHAR *, const nvIPFIX_CHAR * );
+static bool nvipfix_import_find_records( nvIPFIX_import_parser_t * );
+static bool nvipfix_import_find_header( nvIPFIX_import_parser_t * );
+static const nvIPFIX_CHAR * nvipfix_import_find_boundary( const nvIPFIX_import_parser_t *, const nvIPFIX_CHAR *,
+		const nvIPFIX_CHAR * );
+static bool nvipfix_import_parse_chunks( const nvIPFIX_import_parser_t *, const nvIPFIX_CHAR *,
+		nvIPFIX_data_record_list_t * *, size_t * );
+static nvIPFIX_IMPORT_STATUS nvipfix_import_parse_records( nvIPFIX_import_parser_t *, const nvIPFIX_CHAR *, size_t,
+		nvIPFIX_data_record_list_t * *, size_t * );
+static nvIPFIX_IMPORT_COMPRESSION nvipfix_import_get_compression( const nvIPFIX_CHAR *, size_t );
+static bool nvipfix_import_stream_decompress( nvIPFIX_import_stream_t *, nvIPFIX_IMPORT_COMPRESSION );
+#ifdef NVIPFIX_IMPORT_USE_DECOMPRESS
+static void * nvipfix_import_decompress( void * );
+static bool nvipfix_import_decompress_write( nvIPFIX_import_decompressor_t *, size_t );
+#ifdef NVIPFIX_DEF_ENABLE_ZLIB
+static bool nvipfix_import_decompress_gzip( nvIPFIX_import_decompressor_t * );
+#endif
+#ifdef NVIPFIX_DEF_ENABLE_ZSTD
+static bool nvipfix_import_decompress_zstd( nvIPFIX_import_decompressor_t * );
+#endif
+#endif
+static nvIPFIX_import_stream_t * nvipfix_import_stream_open_window( const nvIPFIX_CHAR *, size_t, nvIPFIX_U32 );
+static bool nvipfix_import_stream_fill( nvIPFIX_import_stream_t * );
+static bool nvipfix_import_stream_parse_chunks( nvIPFIX_import_stream_t *, size_t,
+		nvIPFIX_data_record_list_t * *, size_t * );
+static nvIPFIX_IMPORT_STATUS nvipfix_import_parse_record( nvIPFIX_import_parser_t *, nvIPFIX_data_record_t * );
+static nvIPFIX_IMPORT_STATUS nvipfix_import_parse_row( nvIPFIX_import_parser_t *, nvIPFIX_data_record_t * );
+static bool nvipfix_import_set_item( nvIPFIX_import_parser_t *, nvIPFIX_data_record_t *, const nvIPFIX_import_item_t *,
+		const nvIPFIX_string_span_t *, const nvIPFIX_string_span_t * );
 
 
 enum {
-	SizeofFileBuffer = 64 * 1024
+	SizeofFileBuffer = 64 * 1024,
+	SizeofValueBuffer = 64,
+	SizeofItemsIndex = 64,
+	SizeofChunkMin = 1024 * 1024,
+	SizeofStreamWindow = 16 * 1024 * 1024,
+	SizeofPeekWindow = 64 * 1024,
+	SizeofStreamBatch = 64 * 1024,
+	SizeofMagic = 4,
+	SizeofDecompressBuffer = 256 * 1024
 };
 
+static const nvIPFIX_CHAR RecordsName[] = "data";
+
+static const nvIPFIX_BYTE GzipMagic[] = { 0x1f, 0x8b };
+static const nvIPFIX_BYTE ZstdMagic[] = { 0x28, 0xb5, 0x2f, 0xfd };
+
 
 static const nvIPFIX_import_item_t Items[] = {
-		NVIPFIX_IMPORT_ITEM( "vlan", vlanId, nvipfix_parse_u16 ),
-		NVIPFIX_IMPORT_ITEM( "src-switch-port", ingressInterface, nvipfix_import_parse_ingress ),
-		NVIPFIX_IMPORT_ITEM( "dst-switch-port", egressInterface, nvipfix_import_parse_egress ),
-		NVIPFIX_IMPORT_ITEM( "dscp", dscp, nvipfix_parse_byte ),
-		NVIPFIX_IMPORT_ITEM( "src-port", sourcePort, nvipfix_parse_u16 ),
-		NVIPFIX_IMPORT_ITEM( "dst-port", destinationPort, nvipfix_parse_u16 ),
-		NVIPFIX_IMPORT_ITEM( "ibytes", responderOctets, nvipfix_parse_u64 ),
-		NVIPFIX_IMPORT_ITEM( "obytes", initiatorOctets, nvipfix_parse_u64 ),
-		NVIPFIX_IMPORT_ITEM( "total-bytes", transportOctetDeltaCount, nvipfix_parse_u64 ),
-		NVIPFIX_IMPORT_ITEM( "vxlan", layer2SegmentId, nvipfix_import_parse_layer2 ),
-		NVIPFIX_IMPORT_ITEM( "cur-state", tcpControlBits, nvipfix_import_parse_tcp_control_flags ),
-		NVIPFIX_IMPORT_ITEM( "proto", protocol, nvipfix_import_parse_protocol ),
-		NVIPFIX_IMPORT_ITEM( "ether-type", ethernetType, nvipfix_import_parse_ethernet_type ),
-		NVIPFIX_IMPORT_ITEM( "src-mac", sourceMac, nvipfix_parse_mac_address ),
-		NVIPFIX_IMPORT_ITEM( "dst-mac", destinationMac, nvipfix_parse_mac_address ),
-		NVIPFIX_IMPORT_ITEM( "src-ip", sourceIp, nvipfix_parse_ip_address ),
-		NVIPFIX_IMPORT_ITEM( "dst-ip", destinationIp, nvipfix_parse_ip_address ),
-		NVIPFIX_IMPORT_ITEM( "dur", flowDuration, nvipfix_parse_timespan_microseconds ),
-		NVIPFIX_IMPORT_ITEM( "started-time", flowStart, nvipfix_parse_datetime_iso8601 ),
-		NVIPFIX_IMPORT_ITEM( "ended-time", flowEnd, nvipfix_parse_datetime_iso8601 ),
-		NVIPFIX_IMPORT_ITEM( "ended-time", flowEnd, nvipfix_parse_datetime_iso8601 ),
-		NVIPFIX_IMPORT_ITEM( "latency", latency, nvipfix_parse_timespan_microseconds ),
+		NVIPFIX_IMPORT_ITEM( "vlan", vlanId, NV_IPFIX_DATA_FIELD_VLAN_ID, nvipfix_parse_u16 ),
+		NVIPFIX_IMPORT_ITEM( "src-switch-port", ingressInterface, NV_IPFIX_DATA_FIELD_INGRESS_INTERFACE, nvipfix_import_parse_ingress ),
+		NVIPFIX_IMPORT_ITEM( "dst-switch-port", egressInterface, NV_IPFIX_DATA_FIELD_EGRESS_INTERFACE, nvipfix_import_parse_egress ),
+		NVIPFIX_IMPORT_ITEM( "dscp", dscp, NV_IPFIX_DATA_FIELD_DSCP, nvipfix_parse_byte ),
+		NVIPFIX_IMPORT_ITEM( "src-port", sourcePort, NV_IPFIX_DATA_FIELD_SOURCE_PORT, nvipfix_parse_u16 ),
+		NVIPFIX_IMPORT_ITEM( "dst-port", destinationPort, NV_IPFIX_DATA_FIELD_DESTINATION_PORT, nvipfix_parse_u16 ),
+		NVIPFIX_IMPORT_ITEM( "ibytes", responderOctets, NV_IPFIX_DATA_FIELD_RESPONDER_OCTETS, nvipfix_parse_u64 ),
+		NVIPFIX_IMPORT_ITEM( "obytes", initiatorOctets, NV_IPFIX_DATA_FIELD_INITIATOR_OCTETS, nvipfix_parse_u64 ),
+		NVIPFIX_IMPORT_ITEM( "total-bytes", transportOctetDeltaCount, NV_IPFIX_DATA_FIELD_TRANSPORT_OCTET_DELTA_COUNT, nvipfix_parse_u64 ),
+		NVIPFIX_IMPORT_ITEM( "vxlan", layer2SegmentId, NV_IPFIX_DATA_FIELD_LAYER2_SEGMENT_ID, nvipfix_import_parse_layer2 ),
+		NVIPFIX_IMPORT_ITEM( "cur-state", tcpControlBits, NV_IPFIX_DATA_FIELD_TCP_CONTROL_BITS, nvipfix_import_parse_tcp_control_flags ),
+		NVIPFIX_IMPORT_ITEM( "proto", protocol, NV_IPFIX_DATA_FIELD_PROTOCOL, nvipfix_import_parse_protocol ),
+		NVIPFIX_IMPORT_ITEM( "ether-type", ethernetType, NV_IPFIX_DATA_FIELD_ETHERNET_TYPE, nvipfix_import_parse_ethernet_type ),
+		NVIPFIX_IMPORT_ITEM( "src-mac", sourceMac, NV_IPFIX_DATA_FIELD_SOURCE_MAC, nvipfix_parse_mac_address ),
+		NVIPFIX_IMPORT_ITEM( "dst-mac", destinationMac, NV_IPFIX_DATA_FIELD_DESTINATION_MAC, nvipfix_parse_mac_address ),
+		NVIPFIX_IMPORT_ITEM( "src-ip", sourceIp, NV_IPFIX_DATA_FIELD_SOURCE_IP, nvipfix_parse_ip_address ),
+		NVIPFIX_IMPORT_ITEM( "dst-ip", destinationIp, NV_IPFIX_DATA_FIELD_DESTINATION_IP, nvipfix_parse_ip_address ),
+		NVIPFIX_IMPORT_ITEM( "dur", flowDuration, NV_IPFIX_DATA_FIELD_FLOW_DURATION, nvipfix_parse_timespan_microseconds ),
+		NVIPFIX_IMPORT_ITEM( "started-time", flowStart, NV_IPFIX_DATA_FIELD_FLOW_START, nvipfix_parse_datetime_iso8601 ),
+		NVIPFIX_IMPORT_ITEM( "ended-time", flowEnd, NV_IPFIX_DATA_FIELD_FLOW_END, nvipfix_parse_datetime_iso8601 ),
+		NVIPFIX_IMPORT_ITEM( "latency", latency, NV_IPFIX_DATA_FIELD_LATENCY, nvipfix_parse_timespan_microseconds ),
 		{ NULL }
 };
 
 static const size_t ItemsCount = ((sizeof Items) / sizeof (nvIPFIX_import_item_t)) - 1;
 
+static const nvIPFIX_import_item_t * ItemsIndex[SizeofItemsIndex] = { NULL };
+static bool IsItemsIndexPerfect = false;
+
+static nvIPFIX_U32 RecordFields = NV_IPFIX_DATA_FIELD_ALL;
+
+#ifdef NVIPFIX_IMPORT_USE_SSE2
+static nvIPFIX_import_index_block_ft IndexBlock = nvipfix_import_index_block_sse2;
+#else
+static nvIPFIX_import_index_block_ft IndexBlock = nvipfix_import_index_block;
+#endif
+
 
 nvIPFIX_data_record_list_t * nvipfix_import( FILE * a_file )
 {
 	nvIPFIX_data_record_list_t * result = NULL;
 
 	if (a_file != NULL) {
-		size_t index = 0;
+		size_t len = 0;
 		char * buffer = NULL;
 		size_t bufferSize = 0;
 
 		do {
-			bufferSize += SizeofFileBuffer;
+			bufferSize = (bufferSize == 0) ? SizeofFileBuffer : bufferSize * 2;
 			char * newBuffer = realloc( buffer, bufferSize );
 
 			if (newBuffer == NULL) {
@@ -127,381 +343,2645 @@ nvIPFIX_data_record_list_t * nvipfix_import( FILE * a_file )
 
 			buffer = newBuffer;
 
-			fread( buffer + index, 1, SizeofFileBuffer, a_file );
-
-			index += (SizeofFileBuffer - 1);
-		} while (!feof( a_file ));
+			len += fread( buffer + len, 1, bufferSize - len, a_file );
+		} while (!feof( a_file ) && !ferror( a_file ));
 
 		if (buffer != NULL) {
-			NVIPFIX_LOG_DEBUG0( "data len = %d", (unsigned)strlen( buffer ) );
-			nvIPFIX_string_list_t * tokens = nvipfix_string_split( buffer, "[]" );
+			NVIPFIX_LOG_DEBUG0( "data len = %u", (unsigned)len );
+
+			result = nvipfix_import_buffer( buffer, len );
+
+			free( buffer );
+		}
+		else {
+			nvipfix_log_error( "%s: memory allocation failed", __func__ );
+		}
+	}
+	else {
+		nvipfix_log_error( "%s: FILE is null", __func__ );
+	}
 
-			if (tokens != NULL) {
-				NVIPFIX_LOG_DEBUG0( "tokens count = %d", (unsigned)tokens->count );
+	return result;
+}
 
-				nvIPFIX_string_list_item_t * token = tokens->head;
+nvIPFIX_data_record_list_t * nvipfix_import_buffer( const nvIPFIX_CHAR * a_buffer, size_t a_len )
+{
+	nvIPFIX_data_record_list_t * result = NULL;
 
-				while (token != NULL) {
-					nvIPFIX_CHAR * tokenCopy = nvipfix_string_trim_copy( token->value, "{}\r\n\t \":" );
+	NVIPFIX_NULL_ARGS_GUARD_1( a_buffer, NULL );
 
-					if (tokenCopy != NULL) {
-						if (strcmp( "data", tokenCopy ) == 0 && token->next != NULL) {
-							token = token->next;
-							nvIPFIX_string_list_t * records = nvipfix_string_split( token->value, "{" );
+	nvipfix_import_init();
 
-							if (records != NULL) {
-								NVIPFIX_LOG_DEBUG0( "records count = %d", (unsigned)records->count );
+	nvIPFIX_import_parser_t parser = { .cursor = a_buffer, .end = a_buffer + a_len, .isLast = true,
+			.fields = RecordFields };
 
-								nvIPFIX_string_list_item_t * record = records->head;
+	if (nvipfix_import_find_records( &parser )) {
+		size_t count = 0;
 
-								while (record != NULL) {
-									nvIPFIX_data_record_t data = { 0 };
-									nvIPFIX_string_list_t * items = nvipfix_string_split(
-											nvipfix_string_trim( (nvIPFIX_CHAR *)record->value, ",}" ),
-											"," );
+		if (!nvipfix_import_parse_chunks( &parser, NULL, &result, &count )) {
+			nvIPFIX_IMPORT_STATUS status = nvipfix_import_parse_records( &parser, NULL, SIZE_MAX, &result, &count );
 
-									if (items != NULL) {
-										nvIPFIX_string_list_item_t * item = items->head;
+			if (status == NV_IPFIX_IMPORT_STATUS_ERROR) {
+				nvipfix_log_error( "%s: malformed data at offset %u", __func__,
+						(unsigned)(parser.cursor - a_buffer) );
+			}
+		}
 
-										while (item != NULL) {
-											if (item->value != NULL) {
-												char * delimiterPtr = strchr( item->value, ':' );
+		NVIPFIX_LOG_DEBUG0( "records count = %u", (unsigned)count );
+	}
+	else {
+		nvipfix_log_error( "%s: no data records found", __func__ );
+	}
 
-												if (delimiterPtr != NULL) {
-													*delimiterPtr = '\v';
+	return result;
+}
 
-													nvIPFIX_string_list_t * itemPair = nvipfix_string_split(
-															item->value, "\v" );
+nvIPFIX_data_record_list_t * nvipfix_import_file( const nvIPFIX_CHAR * a_fileName )
+{
+	nvIPFIX_data_record_list_t * result = NULL;
 
-													if (itemPair != NULL) {
-														if (itemPair->count == 2) {
-															nvIPFIX_CHAR * itemName = nvipfix_string_trim(
-																	(nvIPFIX_CHAR *)itemPair->head->value, " \t\r\n\"" );
+#ifdef NVIPFIX_DEF_POSIX
+	size_t len = 0;
+	void * map = nvipfix_import_map_file( a_fileName, &len );
 
-															nvIPFIX_CHAR * itemValue = nvipfix_string_trim(
-																	(nvIPFIX_CHAR *)itemPair->tail->value, " \t\r\n\"" );
+	if (map != NULL) {
+		bool isCompressed = nvipfix_import_get_compression( map, len ) != NV_IPFIX_IMPORT_COMPRESSION_NONE;
 
-															if (itemName != NULL && itemValue != NULL) {
-																const nvIPFIX_import_item_t * importItem =
-																		nvipfix_import_get_item( itemName );
+		if (!isCompressed) {
+			result = nvipfix_import_buffer( map, len );
+		}
 
-																if (importItem != NULL) {
-																	importItem->parseValue(
-																			itemValue,
-																			((char *)&data) + importItem->offset );
-																}
-																else {
-																	nvipfix_log_warning(
-																			"%s: unknown item = '%s'",
-																			__func__, itemName );
-																}
-															}
-														}
+		munmap( map, len );
 
-														nvipfix_string_list_free( itemPair, true );
-													}
-												}
-											}
+		if (!isCompressed) {
+			return result;
+		}
+	}
+#endif
 
-											item = item->next;
-										}
+	/*
+	 * compressed or not mappable: stream it, the stream decompresses on its own thread
+	 */
+	nvIPFIX_import_stream_t * stream = nvipfix_import_stream_open( a_fileName );
 
-										nvIPFIX_data_record_list_t * list = nvipfix_data_list_add_copy( result, &data );
-										result = (list != NULL) ? list : result;
+	if (stream != NULL) {
+		nvIPFIX_data_record_list_t * list;
 
-										nvipfix_string_list_free( items, true );
-									}
+		while ((list = nvipfix_import_stream_read( stream, SizeofStreamBatch )) != NULL) {
+			result = nvipfix_data_list_concat( result, list );
+		}
 
-									record = record->next;
-								}
+		nvipfix_import_stream_close( stream );
+	}
 
-								nvipfix_string_list_free( records, true );
-							}
-						}
+	return result;
+}
 
-						free( tokenCopy );
-					}
+void nvipfix_import_set_record_fields( nvIPFIX_U32 a_fields )
+{
+	RecordFields = a_fields;
+}
 
-					token = token->next;
-				}
+bool nvipfix_import_file_get_start( const nvIPFIX_CHAR * a_fileName, nvIPFIX_datetime_t * a_start )
+{
+	bool result = false;
 
-				nvipfix_string_list_free( tokens, true );
-			}
-			else {
-				nvipfix_log_error( "%s: unable to tokenize data file", __func__ );
-			}
+	NVIPFIX_NULL_ARGS_GUARD_2( a_fileName, a_start, false );
 
-			free( buffer );
-		}
-		else {
-			nvipfix_log_error( "%s: memory allocation failed", __func__ );
+	nvIPFIX_import_stream_t * stream = nvipfix_import_stream_open_window( a_fileName, SizeofPeekWindow,
+			NV_IPFIX_DATA_FIELD_FLOW_START );
+
+	if (stream != NULL) {
+		nvIPFIX_data_record_list_t * list = nvipfix_import_stream_read( stream, 1 );
+
+		if (list != NULL && list->head->flowStart.hasValue) {
+			*a_start = list->head->flowStart;
+			result = true;
 		}
-	}
-	else {
-		nvipfix_log_error( "%s: FILE is null", __func__ );
+
+		nvipfix_data_list_free( list );
+		nvipfix_import_stream_close( stream );
 	}
 
 	return result;
 }
 
-nvIPFIX_data_record_list_t * nvipfix_import_file( const nvIPFIX_CHAR * a_fileName )
+nvIPFIX_import_stream_t * nvipfix_import_stream_open( const nvIPFIX_CHAR * a_fileName )
 {
-	nvIPFIX_data_record_list_t * result = NULL;
+	NVIPFIX_NULL_ARGS_GUARD_1( a_fileName, NULL );
+
+	return nvipfix_import_stream_open_window( a_fileName, SizeofStreamWindow, RecordFields );
+}
+
+/**
+ *
+ * @param a_fileName
+ * @param a_windowSize largest record size the stream can parse
+ * @param a_fields nvIPFIX_DATA_FIELD flags of the fields to parse
+ * @return
+ */
+nvIPFIX_import_stream_t * nvipfix_import_stream_open_window( const nvIPFIX_CHAR * a_fileName, size_t a_windowSize,
+		nvIPFIX_U32 a_fields )
+{
+	nvipfix_import_init();
 
-	FILE * dataFile = fopen( a_fileName, "r" );
+	nvIPFIX_import_stream_t * result = calloc( 1, sizeof (nvIPFIX_import_stream_t) );
 
-	if (dataFile != NULL) {
-		result = nvipfix_import( dataFile );
-		fclose( dataFile );
+	if (result != NULL) {
+		result->window = malloc( a_windowSize );
+		result->windowSize = a_windowSize;
+		result->parser.fields = a_fields;
+		result->file = (strcmp( a_fileName, "-" ) == 0) ? stdin : fopen( a_fileName, "r" );
+
+		if (result->window == NULL || result->file == NULL) {
+			nvipfix_log_error( "%s: unable to open file '%s'", __func__, a_fileName );
+			nvipfix_import_stream_close( result );
+			result = NULL;
+		}
+		else {
+			/*
+			 * the magic stays at the front of the window unless the input turns out to be compressed
+			 */
+			result->len = fread( result->window, 1, SizeofMagic, result->file );
+			result->parser.cursor = result->window;
+			result->parser.end = result->window + result->len;
+
+			nvIPFIX_IMPORT_COMPRESSION compression = nvipfix_import_get_compression( result->window, result->len );
+
+			if (compression != NV_IPFIX_IMPORT_COMPRESSION_NONE
+					&& !nvipfix_import_stream_decompress( result, compression )) {
+				nvipfix_import_stream_close( result );
+				result = NULL;
+			}
+		}
 	}
 	else {
-		nvipfix_log_error( "%s: unable to open file '%s'", __func__, a_fileName );
+		nvipfix_log_error( "%s: memory allocation failed", __func__ );
 	}
 
 	return result;
 }
 
-#ifdef NVIPFIX_DEF_ENABLE_NVC
-
-static int nvipfix_import_conn_stat_handler( void * a_arg, uint64_t a_fields, nvc_conn_t * a_connStat )
+nvIPFIX_data_record_list_t * nvipfix_import_stream_read( nvIPFIX_import_stream_t * a_stream, size_t a_maxRecords )
 {
-    NVIPFIX_LOG_TRACE( "%d.%d.%d.%d -> %d.%d.%d.%d %d-%d %d",
-			(unsigned)*((uint8_t *)&(a_connStat->conn_client_ip) + 12),
-			(unsigned)*((uint8_t *)&(a_connStat->conn_client_ip) + 13),
-			(unsigned)*((uint8_t *)&(a_connStat->conn_client_ip) + 14),
-			(unsigned)*((uint8_t *)&(a_connStat->conn_client_ip) + 15),
-			(unsigned)*((uint8_t *)&(a_connStat->conn_server_ip) + 12),
-			(unsigned)*((uint8_t *)&(a_connStat->conn_server_ip) + 13),
-			(unsigned)*((uint8_t *)&(a_connStat->conn_server_ip) + 14),
-			(unsigned)*((uint8_t *)&(a_connStat->conn_server_ip) + 15),
-			(unsigned)a_connStat->conn_started_time, (unsigned)a_connStat->conn_ended_time,
-			(unsigned)a_connStat->conn_vxlan
-			);
-
-    if (a_connStat != NULL) {
-    	nvIPFIX_data_record_list_t * * listPtr = a_arg;
-    	nvIPFIX_data_record_t data = {
-			.vlanId = a_connStat->conn_vlan,
-			.protocol = a_connStat->conn_proto,
-			.ethernetType = a_connStat->conn_ether_type,
-			.tcpControlBits = NVIPFIX_NVC_GET_TCP_FLAGS_FROM_STATE( a_connStat->conn_state ),
-            .ingressInterface = a_connStat->conn_client_switch_port,
-            .egressInterface = a_connStat->conn_server_switch_port,
-            .responderOctets = a_connStat->conn_bytes_recv,
-            .initiatorOctets = a_connStat->conn_bytes_sent,
-            .transportOctetDeltaCount = a_connStat->conn_bytes_total,
-			.sourcePort = a_connStat->conn_client_port,
-			.destinationPort = a_connStat->conn_server_port
-        };
-    
-        NVIPFIX_TIMESPAN_SET_NANOSECONDS( data.flowDuration, a_connStat->conn_dur );
-        NVIPFIX_TIMESPAN_SET_NANOSECONDS( data.latency, a_connStat->conn_avg_latency );
-        
-        NVIPFIX_IN6_ADDR_TO_IP_ADDRESS( data.sourceIp, a_connStat->conn_client_ip );
-        NVIPFIX_IN6_ADDR_TO_IP_ADDRESS( data.destinationIp, a_connStat->conn_server_ip );
-
-        NVIPFIX_ETHER_ADDR_TO_MAC_ADDRESS( data.sourceMac, a_connStat->conn_client_mac_addr );
-        NVIPFIX_ETHER_ADDR_TO_MAC_ADDRESS( data.destinationMac, a_connStat->conn_server_mac_addr );
+	nvIPFIX_data_record_list_t * result = NULL;
 
-        nvipfix_ctime_to_datetime( &(data.flowStart), (time_t *)&(a_connStat->conn_started_time) );
-        nvipfix_ctime_to_datetime( &(data.flowEnd), (time_t *)&(a_connStat->conn_ended_time) );
+	NVIPFIX_NULL_ARGS_GUARD_1( a_stream, NULL );
 
-//		nvIPFIX_BYTE dscp;
-//		nvIPFIX_U64 layer2SegmentId;
-//
+	nvIPFIX_import_parser_t * parser = &(a_stream->parser);
+	size_t count = 0;
 
-        nvIPFIX_data_record_list_t * list = nvipfix_data_list_add_copy( *listPtr, &data );
-        
-        if (list != NULL) {
-            *listPtr = list;
-        }
-    }
-    
-    return 0;
-}
+	while (!a_stream->isDone && count < a_maxRecords) {
+		if (!a_stream->isInRecords) {
+			a_stream->isInRecords = nvipfix_import_find_records( parser );
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wunused-but-set-variable"
-nvIPFIX_data_record_list_t * nvipfix_import_nvc( const nvIPFIX_CHAR * a_host, 
-    const nvIPFIX_CHAR * a_login, const nvIPFIX_CHAR * a_password, 
-    const nvIPFIX_datetime_t * a_startTs, const nvIPFIX_datetime_t * a_endTs, int within_last )
-{
-    nvIPFIX_data_record_list_t * result = NULL;
-    struct timespec ts_now;
+			if (!a_stream->isInRecords && (a_stream->isEof || a_stream->len == a_stream->windowSize)) {
+				nvipfix_log_error( "%s: no data records found", __func__ );
+				a_stream->isDone = true;
+			}
+			else if (!a_stream->isInRecords) {
+				nvipfix_import_stream_fill( a_stream );
+			}
 
-    NVIPFIX_ERROR_INIT( error );
+			continue;
+		}
 
-    nvOS_io_t io = { 0 };
+		const nvIPFIX_CHAR * start = parser->cursor;
+		size_t startCount = count;
 
-    if (a_host != NULL) {
-        CRYPTO_malloc_init();
-        SSL_library_init();
-        SSL_load_error_strings();
-        ERR_load_BIO_strings();
-        OpenSSL_add_all_algorithms();
-        
-        nvc_init_net( &io, NVIPFIX_CHAR_PTR_TO_CCHAR_PTR( a_host ) );
-    }
-    else {
-		nvc_init( &io );
-    }
-    
-    nvOS_result_t nvcResult;
-    int nvcError;
+		if (nvipfix_import_stream_parse_chunks( a_stream, a_maxRecords - count, &result, &count )) {
+			if (count > startCount) {
+				a_stream->recordSize = (parser->cursor - start) / (count - startCount);
+			}
 
-    nvcError = nvc_connect( &io );
-    NVIPFIX_ERROR_RAISE_IF( nvcError != 0, error, NV_IPFIX_ERROR_CODE_NVC_CONNECT, Connect, 
-        "nvc_connect: %d", nvcError );
-    
-    if (a_login != NULL && a_password != NULL) {
-		nvcError = nvc_authenticate( &io,
-				NVIPFIX_CHAR_PTR_TO_CCHAR_PTR( a_login ),
-				NVIPFIX_CHAR_PTR_TO_CCHAR_PTR( a_password ),
-				&nvcResult );
-    } 
-    else {
-		char userName[nvc_PCL_NAME_LEN];
-		nvcError = nvc_check_uid( &io, userName, sizeof userName, &nvcResult );
-    }
+			continue;
+		}
 
-    NVIPFIX_ERROR_RAISE_IF( nvcResult.res_status != nvOS_SUCCESS, error, NV_IPFIX_ERROR_CODE_NVC_AUTH, Auth,
-        "%s", nvcResult.res_msg );
+		nvIPFIX_IMPORT_STATUS status = nvipfix_import_parse_records( parser, NULL, a_maxRecords - count,
+				&result, &count );
 
-    NVIPFIX_ERROR_RAISE_IF( nvcError != 0, error, NV_IPFIX_ERROR_CODE_NVC_AUTH, Auth, 
-        "nvc_authenticate/nvc_check_uid: %d", nvcError );
+		if (count > startCount) {
+			a_stream->recordSize = (parser->record - start) / (count - startCount);
+		}
 
-    nvc_conn_t filter = { { 0 } };
-    uint64_t filterFields = 0;
-    clock_gettime( CLOCK_REALTIME, &ts_now );
-    filter.conn_args.within_last = within_last;
-    nvc_FIELD_FLAG_SET( filterFields, nvc_stats_args_within_last );
+		if (status == NV_IPFIX_IMPORT_STATUS_RECORD) {
+			continue;
+		}
 
-    nvc_format_args_t format = { { 0 } };
-    uint64_t formatFields = 0;
-    format.limit_output = 10000;
-    nvc_FIELD_FLAG_SET( formatFields, nvc_format_args_limit_output );
+		/*
+		 * a record cut by the end of the window: parse it again after a refill
+		 */
+		if (!a_stream->isEof && (status == NV_IPFIX_IMPORT_STATUS_ERROR || parser->cursor == parser->end)) {
+			parser->cursor = parser->record;
 
-    NVIPFIX_LOG_DEBUG( "within last = %u", (unsigned) filter.conn_args.within_last );
+			if (parser->cursor == a_stream->window && a_stream->len == a_stream->windowSize) {
+				nvipfix_log_error( "%s: record too large at offset %u", __func__, (unsigned)a_stream->offset );
+				a_stream->isDone = true;
+			}
+			else {
+				nvipfix_import_stream_fill( a_stream );
+			}
+		}
+		else {
+			if (status == NV_IPFIX_IMPORT_STATUS_ERROR) {
+				nvipfix_log_error( "%s: malformed data at offset %u", __func__,
+						(unsigned)(a_stream->offset + (parser->cursor - a_stream->window)) );
+			}
 
-    nvcError = nvc_show_conn_stat( &io, 
-        filterFields, &filter, 
-        formatFields, &format,
-        nvipfix_import_conn_stat_handler, &result,
-		&nvcResult );
+			a_stream->isDone = true;
+		}
+	}
 
-    NVIPFIX_ERROR_RAISE_IF( nvcResult.res_status != nvOS_SUCCESS, error, NV_IPFIX_ERROR_CODE_NVC_CONN_STAT, ConnStat,
-        "%s", nvcResult.res_msg );
+	NVIPFIX_LOG_DEBUG0( "records count = %u", (unsigned)count );
 
-    NVIPFIX_ERROR_RAISE_IF( nvcError != 0, error, NV_IPFIX_ERROR_CODE_NVC_CONN_STAT, ConnStat, 
-        "nvc_show_conn_stat: %d", nvcError );
+	return result;
+}
 
-    NVIPFIX_ERROR_HANDLER( ConnStat );
-    nvc_logout( &io );
+void nvipfix_import_stream_close( nvIPFIX_import_stream_t * a_stream )
+{
+	NVIPFIX_NULL_ARGS_GUARD_1_VOID( a_stream );
 
-    NVIPFIX_ERROR_HANDLER( Auth );
-    nvc_disconnect( &io );
-    
-    NVIPFIX_ERROR_HANDLER( Connect );
-    nvc_done( &io );
- 
-    return result;
-}
-#pragma GCC diagnostic pop
+	if (a_stream->file != NULL && a_stream->file != stdin) {
+		fclose( a_stream->file );
+	}
 
-#endif
+#ifdef NVIPFIX_IMPORT_USE_DECOMPRESS
+	nvIPFIX_import_decompressor_t * decompressor = &(a_stream->decompressor);
 
-bool nvipfix_import_parse_ingress( const char * a_s, void * a_value )
-{
-	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
+	/*
+	 * the pipe is closed above: a decompressor still writing fails with EPIPE and exits
+	 */
+	if (decompressor->isStarted) {
+		pthread_join( decompressor->thread, NULL );
+	}
 
-	return nvipfix_parse_u32( a_s, a_value );
-}
+	if (decompressor->file != NULL && decompressor->file != stdin) {
+		fclose( decompressor->file );
+	}
 
-bool nvipfix_import_parse_egress( const char * a_s, void * a_value )
-{
-	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
+	free( decompressor->in );
+	free( decompressor->out );
+#endif
 
-	return nvipfix_parse_u32( a_s, a_value );
+	free( a_stream->window );
+	free( a_stream );
 }
 
-bool nvipfix_import_parse_layer2( const char * a_s, void * a_value )
+/**
+ * detect compressed input by its magic bytes
+ * @param a_s
+ * @param a_len
+ * @return
+ */
+nvIPFIX_IMPORT_COMPRESSION nvipfix_import_get_compression( const nvIPFIX_CHAR * a_s, size_t a_len )
 {
-	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
-
-	bool result = nvipfix_parse_u64( a_s, a_value );
+	nvIPFIX_IMPORT_COMPRESSION result = NV_IPFIX_IMPORT_COMPRESSION_NONE;
 
-	if (result) {
-		nvIPFIX_U64 * u64Ptr = a_value;
-		*u64Ptr |= ((nvIPFIX_U64)NV_IPFIX_LAYER2_NETWORK_TYPE_VxLAN << 56);
+	if (a_len >= sizeof GzipMagic && memcmp( a_s, GzipMagic, sizeof GzipMagic ) == 0) {
+		result = NV_IPFIX_IMPORT_COMPRESSION_GZIP;
+	}
+	else if (a_len >= sizeof ZstdMagic && memcmp( a_s, ZstdMagic, sizeof ZstdMagic ) == 0) {
+		result = NV_IPFIX_IMPORT_COMPRESSION_ZSTD;
 	}
 
 	return result;
 }
 
-bool nvipfix_import_parse_tcp_control_flags( const char * a_s, void * a_value )
+/**
+ * start decompressing the stream input on a separate thread, the stream then reads the output from a pipe
+ * @param a_stream input magic is in the window
+ * @param a_compression
+ * @return false if the compression is not supported by this build or the thread cannot be started
+ */
+bool nvipfix_import_stream_decompress( nvIPFIX_import_stream_t * a_stream, nvIPFIX_IMPORT_COMPRESSION a_compression )
 {
-	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
+	bool result = false;
 
-	bool result = true;
-	nvIPFIX_TCP_CONTROL_FLAG * flagPtr = a_value;
+#ifdef NVIPFIX_IMPORT_USE_DECOMPRESS
+	nvIPFIX_import_decompressor_t * decompressor = &(a_stream->decompressor);
+	int fds[2];
 
-	if (strcmp( "fin", a_s ) == 0) {
-		*flagPtr = NV_IPFIX_TCP_CONTROL_FLAG_FIN;
+#ifndef NVIPFIX_DEF_ENABLE_ZLIB
+	if (a_compression == NV_IPFIX_IMPORT_COMPRESSION_GZIP) {
+		nvipfix_log_error( "%s: gzip input is not supported by this build", __func__ );
+		return false;
 	}
-	else if (strcmp( "rst", a_s ) == 0) {
-		*flagPtr = NV_IPFIX_TCP_CONTROL_FLAG_RST;
+#endif
+#ifndef NVIPFIX_DEF_ENABLE_ZSTD
+	if (a_compression == NV_IPFIX_IMPORT_COMPRESSION_ZSTD) {
+		nvipfix_log_error( "%s: zstd input is not supported by this build", __func__ );
+		return false;
 	}
-	else if (strcmp( "syn", a_s ) == 0) {
-		*flagPtr = NV_IPFIX_TCP_CONTROL_FLAG_SYN;
+#endif
+
+	decompressor->in = malloc( SizeofDecompressBuffer );
+	decompressor->out = malloc( SizeofDecompressBuffer );
+
+	if (decompressor->in == NULL || decompressor->out == NULL) {
+		nvipfix_log_error( "%s: memory allocation failed", __func__ );
 	}
-	else if (strcmp( "est", a_s ) == 0) {
-		*flagPtr = NV_IPFIX_TCP_CONTROL_FLAG_ACK;
+	else if (pipe( fds ) != 0) {
+		nvipfix_log_error( "%s: pipe: %s", __func__, strerror( errno ) );
 	}
 	else {
+#ifdef F_SETPIPE_SZ
+		fcntl( fds[1], F_SETPIPE_SZ, SizeofDecompressBuffer );
+#endif
+
+		memcpy( decompressor->in, a_stream->window, a_stream->len );
+		decompressor->inLen = a_stream->len;
+		decompressor->compression = a_compression;
+		decompressor->file = a_stream->file;
+		decompressor->fd = fds[1];
+
+		a_stream->file = fdopen( fds[0], "r" );
+		a_stream->len = 0;
+		a_stream->parser.end = a_stream->window;
+
+		if (a_stream->file == NULL) {
+			close( fds[0] );
+			close( fds[1] );
+			nvipfix_log_error( "%s: fdopen: %s", __func__, strerror( errno ) );
+		}
+		else if (pthread_create( &(decompressor->thread), NULL, nvipfix_import_decompress, decompressor ) != 0) {
+			close( fds[1] );
+			nvipfix_log_error( "%s: unable to start decompressor thread", __func__ );
+		}
+		else {
+			decompressor->isStarted = true;
+			result = true;
+		}
+	}
+#else
+	nvipfix_log_error( "%s: compressed input is not supported by this build", __func__ );
+#endif
+
+	return result;
+}
+
+#ifdef NVIPFIX_IMPORT_USE_DECOMPRESS
+/**
+ * decompressor thread, the write end of the pipe is closed when the input ends or fails
+ * @param a_decompressor
+ * @return
+ */
+void * nvipfix_import_decompress( void * a_decompressor )
+{
+	nvIPFIX_import_decompressor_t * decompressor = a_decompressor;
+	sigset_t sigset;
+
+	/*
+	 * a stream closed early makes writes fail with EPIPE instead of killing the process
+	 */
+	sigemptyset( &sigset );
+	sigaddset( &sigset, SIGPIPE );
+	pthread_sigmask( SIG_BLOCK, &sigset, NULL );
+
+#ifdef NVIPFIX_DEF_ENABLE_ZLIB
+	if (decompressor->compression == NV_IPFIX_IMPORT_COMPRESSION_GZIP) {
+		nvipfix_import_decompress_gzip( decompressor );
+	}
+#endif
+#ifdef NVIPFIX_DEF_ENABLE_ZSTD
+	if (decompressor->compression == NV_IPFIX_IMPORT_COMPRESSION_ZSTD) {
+		nvipfix_import_decompress_zstd( decompressor );
+	}
+#endif
+
+	close( decompressor->fd );
+
+	return NULL;
+}
+
+/**
+ * write decompressed output to the pipe
+ * @param a_decompressor
+ * @param a_len bytes of the out buffer
+ * @return false if the stream is closed
+ */
+bool nvipfix_import_decompress_write( nvIPFIX_import_decompressor_t * a_decompressor, size_t a_len )
+{
+	const nvIPFIX_BYTE * s = a_decompressor->out;
+
+	while (a_len > 0) {
+		ssize_t writeLen = write( a_decompressor->fd, s, a_len );
+
+		if (writeLen < 0 && errno == EINTR) {
+			continue;
+		}
+
+		if (writeLen <= 0) {
+			return false;
+		}
+
+		s += writeLen;
+		a_len -= (size_t)writeLen;
+	}
+
+	return true;
+}
+
+#ifdef NVIPFIX_DEF_ENABLE_ZLIB
+/**
+ * concatenated gzip members are decompressed one after another
+ * @param a_decompressor
+ * @return
+ */
+bool nvipfix_import_decompress_gzip( nvIPFIX_import_decompressor_t * a_decompressor )
+{
+	z_stream zs = { 0 };
+	bool result = inflateInit2( &zs, 16 + MAX_WBITS ) == Z_OK;
+	bool isOutFull = false;
+	bool isMemberEnd = false;
+
+	zs.next_in = a_decompressor->in;
+	zs.avail_in = (uInt)a_decompressor->inLen;
+
+	while (result) {
+		if (zs.avail_in == 0 && !isOutFull) {
+			size_t readLen = fread( a_decompressor->in, 1, SizeofDecompressBuffer, a_decompressor->file );
+
+			if (readLen == 0) {
+				break;
+			}
+
+			zs.next_in = a_decompressor->in;
+			zs.avail_in = (uInt)readLen;
+		}
+
+		zs.next_out = a_decompressor->out;
+		zs.avail_out = SizeofDecompressBuffer;
+
+		int status = inflate( &zs, Z_NO_FLUSH );
+
+		/*
+		 * Z_BUF_ERROR: no progress possible, e.g. right after a member ended with the output buffer full
+		 */
+		if (status != Z_BUF_ERROR) {
+			isMemberEnd = status == Z_STREAM_END;
+		}
+
+		if (isMemberEnd) {
+			inflateReset( &zs );
+		}
+		else if (status != Z_OK && status != Z_BUF_ERROR) {
+			nvipfix_log_error( "%s: inflate failed: %s", __func__, zs.msg != NULL ? zs.msg : "unknown error" );
+			result = false;
+			break;
+		}
+
+		isOutFull = zs.avail_out == 0;
+		result = nvipfix_import_decompress_write( a_decompressor, SizeofDecompressBuffer - zs.avail_out );
+	}
+
+	if (result && !isMemberEnd) {
+		nvipfix_log_error( "%s: truncated gzip input", __func__ );
 		result = false;
 	}
 
+	inflateEnd( &zs );
+
 	return result;
 }
+#endif
 
-bool nvipfix_import_parse_protocol( const char * a_s, void * a_value )
+#ifdef NVIPFIX_DEF_ENABLE_ZSTD
+/**
+ *
+ * @param a_decompressor
+ * @return
+ */
+bool nvipfix_import_decompress_zstd( nvIPFIX_import_decompressor_t * a_decompressor )
 {
-	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
+	ZSTD_DStream * zs = ZSTD_createDStream();
+	bool result = zs != NULL && !ZSTD_isError( ZSTD_initDStream( zs ) );
+	bool isOutFull = false;
+	size_t hint = 0;
+	ZSTD_inBuffer input = { a_decompressor->in, a_decompressor->inLen, 0 };
 
-	nvIPFIX_OCTET protocol;
-	bool result = nvipfix_parse_octet( a_s, &protocol );
+	while (result) {
+		if (input.pos == input.size && !isOutFull) {
+			size_t readLen = fread( a_decompressor->in, 1, SizeofDecompressBuffer, a_decompressor->file );
 
-	if (result) {
-		*((nvIPFIX_PROTOCOL *)a_value) = (nvIPFIX_PROTOCOL)protocol;
+			if (readLen == 0) {
+				break;
+			}
+
+			input.size = readLen;
+			input.pos = 0;
+		}
+
+		ZSTD_outBuffer output = { a_decompressor->out, SizeofDecompressBuffer, 0 };
+
+		hint = ZSTD_decompressStream( zs, &output, &input );
+
+		if (ZSTD_isError( hint )) {
+			nvipfix_log_error( "%s: ZSTD_decompressStream failed: %s", __func__, ZSTD_getErrorName( hint ) );
+			result = false;
+			break;
+		}
+
+		isOutFull = output.pos == output.size;
+		result = nvipfix_import_decompress_write( a_decompressor, output.pos );
 	}
 
+	if (result && hint != 0) {
+		nvipfix_log_error( "%s: truncated zstd input", __func__ );
+		result = false;
+	}
+
+	ZSTD_freeDStream( zs );
+
 	return result;
 }
+#endif
+#endif
 
-bool nvipfix_import_parse_ethernet_type( const char * a_s, void * a_value )
+/**
+ * move the unparsed part of the window to the front and read more input after it
+ * @param a_stream
+ * @return false if nothing was read
+ */
+bool nvipfix_import_stream_fill( nvIPFIX_import_stream_t * a_stream )
 {
-	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
+	nvIPFIX_import_parser_t * parser = &(a_stream->parser);
+	size_t consumed = parser->cursor - a_stream->window;
+	size_t len = a_stream->len - consumed;
 
-	nvIPFIX_U16 type;
-	bool result = nvipfix_parse_u16( a_s, &type );
+	memmove( a_stream->window, parser->cursor, len );
+	a_stream->offset += consumed;
+
+	size_t readLen = 0;
+
+	if (!a_stream->isEof) {
+		readLen = fread( a_stream->window + len, 1, a_stream->windowSize - len, a_stream->file );
+
+		if (readLen < a_stream->windowSize - len) {
+			a_stream->isEof = true;
+
+			if (ferror( a_stream->file )) {
+				nvipfix_log_error( "%s: read failed at offset %u", __func__, (unsigned)(a_stream->offset + len) );
+			}
+		}
+	}
+
+	a_stream->len = len + readLen;
+	parser->cursor = a_stream->window;
+	parser->end = a_stream->window + a_stream->len;
+	parser->block = NULL;
+	parser->isLast = a_stream->isEof;
+
+	return readLen > 0;
+}
+
+/**
+ * parse most of the next batch in chunks, sized from the average record size so far
+ * the last whole records of the window are left for the next refill
+ * @param a_stream
+ * @param a_maxRecords
+ * @param a_list
+ * @param a_count
+ * @return false if nothing was parsed
+ */
+bool nvipfix_import_stream_parse_chunks( nvIPFIX_import_stream_t * a_stream, size_t a_maxRecords,
+		nvIPFIX_data_record_list_t * * a_list, size_t * a_count )
+{
+	nvIPFIX_import_parser_t * parser = &(a_stream->parser);
+	size_t len = parser->end - parser->cursor;
+
+	if (a_stream->recordSize == 0 || len < 2 * SizeofChunkMin) {
+		return false;
+	}
+
+	/*
+	 * aim below the batch size, parse_records tops the batch up
+	 */
+	size_t batchLen = (a_maxRecords - a_maxRecords / 8) * a_stream->recordSize;
+	const nvIPFIX_CHAR * stop = nvipfix_import_find_boundary( parser,
+			parser->cursor + ((batchLen < len - SizeofChunkMin) ? batchLen : len - SizeofChunkMin), parser->end );
+
+	bool result = stop != NULL && nvipfix_import_parse_chunks( parser, stop, a_list, a_count );
 
 	if (result) {
-		*((nvIPFIX_ETHERNET_TYPE *)a_value) = (nvIPFIX_ETHERNET_TYPE)type;
+		parser->cursor = stop;
 	}
 
 	return result;
 }
 
-const nvIPFIX_import_item_t * nvipfix_import_get_item( const char * a_name )
+#ifdef NVIPFIX_DEF_ENABLE_NVC
+
+/**
+ * connection to the switch kept across polls
+ */
+typedef struct {
+	nvOS_io_t io;
+	bool isOpen;					//!< connected and authenticated
+	unsigned failuresCount;			//!< consecutive failed opens
+	time_t retryTime;				//!< no open attempt before this time
+	unsigned long truncationsCount;	//!< chunks cut at the limit since start
+	unsigned streamPartsCount;		//!< sub-windows of a streamed poll, follows the connection count
+	unsigned long cancellationsCount;	//!< polls cut at the deadline since start
+	bool isQuerying;				//!< in nvc_show_conn_stat(), guarded by the deadline mutex
+	bool isBroken;					//!< a reply was cut off, the session is dropped without a logout
+} nvIPFIX_import_nvc_session_t;
+
+/**
+ * end of a poll: the handler stops taking records once it passes, the watchdog
+ * cancels the queries still waiting for the switch
+ */
+typedef struct {
+	time_t time;
+	volatile bool isExpired;
+#ifdef NVIPFIX_IMPORT_USE_NVC_WATCHDOG
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	bool isDone;					//!< the poll finished, the watchdog quits
+#endif
+} nvIPFIX_import_nvc_deadline_t;
+
+/**
+ * one poll: the window is fetched in chunks of at most chunkSize connections
+ */
+typedef struct {
+	const nvIPFIX_CHAR * host;		//!< to open the sessions of a parallel poll
+	const nvIPFIX_CHAR * login;
+	const nvIPFIX_CHAR * password;
+	unsigned sessionsCount;			//!< sessions a large window is polled over
+	nvIPFIX_import_nvc_deadline_t * deadline;	//!< NULL if the poll may take any time
+	nvIPFIX_import_nvc_sink_t sink;
+	const nvIPFIX_conn_filter_t * filter;
+	const nvIPFIX_conn_format_t * format;
+	nvIPFIX_U32 chunkSize;
+	time_t start;					//!< window
+	time_t end;
+	time_t fetchedEnd;				//!< the window is handed over in full up to here
+	size_t handedCount;				//!< chunks or records handed to the sink
+} nvIPFIX_import_nvc_poll_t;
+
+/**
+ * records of one nvc_show_conn_stat() call
+ */
+typedef struct {
+	nvIPFIX_data_record_list_t * list;
+	size_t rowsCount;				//!< rows the switch returned, including those of other sub-windows (the limit counts them)
+	size_t spanningCount;			//!< rows of connections running through the whole sub-window, every part of it returns them
+	time_t start;					//!< sub-window
+	time_t end;
+	bool isCancelled;				//!< the deadline passed before the reply was complete
+	nvIPFIX_import_nvc_poll_t * poll;
+} nvIPFIX_import_nvc_chunk_t;
+
+/**
+ * chunks of a sub-window polled in parallel, kept until the sub-windows before it are handed over
+ */
+typedef struct {
+	nvIPFIX_data_record_list_t ** chunks;
+	size_t count;
+	bool isFailed;					//!< a chunk was lost
+} nvIPFIX_import_nvc_part_t;
+
+enum {
+	NvcRetryDelayMin = 5,			//!< seconds
+	NvcRetryDelayMax = 300,
+	NvcSessionsMax = 16,
+	NvcPartsPerSession = 4			//!< sub-windows of a parallel poll per session, evens out busy periods
+};
+
+
+static bool nvipfix_import_nvc_reopen( nvIPFIX_import_nvc_session_t *, const nvIPFIX_CHAR *, const nvIPFIX_CHAR *,
+		const nvIPFIX_CHAR * );
+static bool nvipfix_import_nvc_open( nvIPFIX_import_nvc_session_t *, const nvIPFIX_CHAR *, const nvIPFIX_CHAR *,
+		const nvIPFIX_CHAR * );
+static bool nvipfix_import_nvc_poll( nvIPFIX_import_nvc_session_t *, nvIPFIX_import_nvc_poll_t * );
+static bool nvipfix_import_nvc_poll_window( nvIPFIX_import_nvc_session_t *, nvIPFIX_import_nvc_poll_t *, time_t, time_t );
+static bool nvipfix_import_nvc_poll_parallel( nvIPFIX_import_nvc_poll_t * );
+static bool nvipfix_import_nvc_check_split( nvIPFIX_import_nvc_session_t *, const nvIPFIX_import_nvc_chunk_t * );
+static void nvipfix_import_nvc_collect_chunk( nvIPFIX_data_record_list_t *, void * );
+static inline bool nvipfix_import_nvc_is_expired( nvIPFIX_import_nvc_deadline_t * );
+static bool nvipfix_import_nvc_deadline_start( nvIPFIX_import_nvc_deadline_t * );
+static void nvipfix_import_nvc_deadline_stop( nvIPFIX_import_nvc_deadline_t * );
+#ifdef NVIPFIX_IMPORT_USE_NVC_WATCHDOG
+static void * nvipfix_import_nvc_watchdog( void * );
+#endif
+static bool nvipfix_import_nvc_poll_stream( nvIPFIX_import_nvc_session_t *, nvIPFIX_import_nvc_poll_t * );
+static bool nvipfix_import_nvc_query( nvIPFIX_import_nvc_session_t *, nvIPFIX_import_nvc_chunk_t *, nvIPFIX_U32 );
+static void nvipfix_import_nvc_set_filter( nvc_conn_t *, uint64_t *, const nvIPFIX_conn_filter_t * );
+static void nvipfix_import_nvc_set_format( nvc_format_args_t *, uint64_t *, const nvIPFIX_conn_format_t * );
+static void nvipfix_import_nvc_close( nvIPFIX_import_nvc_session_t * );
+static void nvipfix_import_nvc_cleanup( void );
+
+
+/**
+ * the first session serves every poll, the others only parallel ones
+ */
+static nvIPFIX_import_nvc_session_t NvcSessions[NvcSessionsMax];
+
+
+static int nvipfix_import_conn_stat_handler( void * a_arg, uint64_t a_fields, nvc_conn_t * a_connStat )
+{
+    NVIPFIX_LOG_TRACE( "%d.%d.%d.%d -> %d.%d.%d.%d %d-%d %d",
+			(unsigned)*((uint8_t *)&(a_connStat->conn_client_ip) + 12),
+			(unsigned)*((uint8_t *)&(a_connStat->conn_client_ip) + 13),
+			(unsigned)*((uint8_t *)&(a_connStat->conn_client_ip) + 14),
+			(unsigned)*((uint8_t *)&(a_connStat->conn_client_ip) + 15),
+			(unsigned)*((uint8_t *)&(a_connStat->conn_server_ip) + 12),
+			(unsigned)*((uint8_t *)&(a_connStat->conn_server_ip) + 13),
+			(unsigned)*((uint8_t *)&(a_connStat->conn_server_ip) + 14),
+			(unsigned)*((uint8_t *)&(a_connStat->conn_server_ip) + 15),
+			(unsigned)a_connStat->conn_started_time, (unsigned)a_connStat->conn_ended_time,
+			(unsigned)a_connStat->conn_vxlan
+			);
+
+    if (a_connStat != NULL) {
+    	nvIPFIX_import_nvc_chunk_t * chunk = a_arg;
+
+    	if (nvipfix_import_nvc_is_expired( chunk->poll->deadline )) {
+    		return -1;
+    	}
+
+    	chunk->rowsCount++;
+
+    	if ((time_t)a_connStat->conn_started_time < chunk->start
+    			&& (a_connStat->conn_ended_time == 0 || (time_t)a_connStat->conn_ended_time >= chunk->end)) {
+    		chunk->spanningCount++;
+    	}
+
+    	/*
+    	 * a connection spanning sub-windows is reported by each of them: keep it only in the one
+    	 * holding its start (connections started before the window belong to the first).
+    	 * Aggregated polls are never split, their rows always come from the whole window
+    	 */
+    	time_t started = (time_t)a_connStat->conn_started_time;
+    	time_t anchor = (started < chunk->poll->start) ? chunk->poll->start
+    			: (started >= chunk->poll->end) ? chunk->poll->end - 1 : started;
+
+    	if (anchor < chunk->start || anchor >= chunk->end) {
+    		return 0;
+    	}
+
+    	nvIPFIX_data_record_t data = {
+			.vlanId = a_connStat->conn_vlan,
+			.protocol = a_connStat->conn_proto,
+			.ethernetType = a_connStat->conn_ether_type,
+			.tcpControlBits = NVIPFIX_NVC_GET_TCP_FLAGS_FROM_STATE( a_connStat->conn_state ),
+            .ingressInterface = a_connStat->conn_client_switch_port,
+            .egressInterface = a_connStat->conn_server_switch_port,
+            .responderOctets = a_connStat->conn_bytes_recv,
+            .initiatorOctets = a_connStat->conn_bytes_sent,
+            .transportOctetDeltaCount = a_connStat->conn_bytes_total,
+            .flowCount = a_connStat->conn_sum_by_count,
+            .transition = NVIPFIX_NVC_GET_FLOW_TRANSITION( a_connStat->conn_trans ),
+			.sourcePort = a_connStat->conn_client_port,
+			.destinationPort = a_connStat->conn_server_port
+        };
+    
+        NVIPFIX_TIMESPAN_SET_NANOSECONDS( data.flowDuration, a_connStat->conn_dur );
+        NVIPFIX_TIMESPAN_SET_NANOSECONDS( data.latency, a_connStat->conn_avg_latency );
+        
+        NVIPFIX_IN6_ADDR_TO_IP_ADDRESS( data.sourceIp, a_connStat->conn_client_ip );
+        NVIPFIX_IN6_ADDR_TO_IP_ADDRESS( data.destinationIp, a_connStat->conn_server_ip );
+
+        NVIPFIX_ETHER_ADDR_TO_MAC_ADDRESS( data.sourceMac, a_connStat->conn_client_mac_addr );
+        NVIPFIX_ETHER_ADDR_TO_MAC_ADDRESS( data.destinationMac, a_connStat->conn_server_mac_addr );
+
+        /*
+         * broken-down time is the only costly conversion, skip it unless an export needs it
+         */
+        if ((RecordFields & NV_IPFIX_DATA_FIELD_FLOW_START) != 0) {
+        	nvipfix_ctime_to_datetime( &(data.flowStart), (time_t *)&(a_connStat->conn_started_time) );
+        }
+
+        if ((RecordFields & NV_IPFIX_DATA_FIELD_FLOW_END) != 0) {
+        	nvipfix_ctime_to_datetime( &(data.flowEnd), (time_t *)&(a_connStat->conn_ended_time) );
+        }
+
+        /*
+         * VNI 0 is what the switch reports for connections outside any VXLAN
+         */
+        if (a_connStat->conn_vxlan != 0) {
+        	data.layer2SegmentId = ((nvIPFIX_U64)NV_IPFIX_LAYER2_NETWORK_TYPE_VxLAN << 56) | a_connStat->conn_vxlan;
+        }
+
+//		nvIPFIX_BYTE dscp;
+
+        if (chunk->poll->sink.recordFunc != NULL) {
+        	chunk->poll->sink.recordFunc( &data, chunk->poll->sink.arg );
+        	chunk->poll->handedCount++;
+        }
+        else {
+			nvIPFIX_data_record_list_t * list = nvipfix_data_list_add_copy( chunk->list, &data );
+
+			if (list != NULL) {
+				chunk->list = list;
+			}
+        }
+    }
+    
+    return 0;
+}
+
+bool nvipfix_import_nvc( const nvIPFIX_CHAR * a_host,
+    const nvIPFIX_CHAR * a_login, const nvIPFIX_CHAR * a_password,
+    time_t a_start, time_t a_end,
+	nvIPFIX_U32 a_chunkSize, unsigned a_sessionsCount, time_t a_deadline,
+	const nvIPFIX_conn_filter_t * a_filter, const nvIPFIX_conn_format_t * a_format,
+	const nvIPFIX_import_nvc_sink_t * a_sink, time_t * a_fetchedEnd )
 {
-	const nvIPFIX_import_item_t * result = NULL;
+    NVIPFIX_NULL_ARGS_GUARD_2( a_sink, a_fetchedEnd, false );
+
+    nvIPFIX_import_nvc_session_t * session = NvcSessions;
+    bool isReused = session->isOpen;
+    nvIPFIX_import_nvc_deadline_t deadline = { .time = a_deadline };
+
+    nvIPFIX_import_nvc_poll_t poll = {
+    		.host = a_host,
+			.login = a_login,
+			.password = a_password,
+			.sessionsCount = (a_sessionsCount < 1) ? 1 : (a_sessionsCount > NvcSessionsMax) ? NvcSessionsMax : a_sessionsCount,
+    		.sink = *a_sink,
+			.filter = a_filter,
+			.format = a_format,
+			.chunkSize = (a_chunkSize > 0) ? a_chunkSize : 1,
+			.start = a_start,
+			.end = a_end,
+			.fetchedEnd = a_start
+    };
+
+    *a_fetchedEnd = a_start;
+
+    if (a_end <= a_start) {
+        NVIPFIX_LOG_DEBUG( "empty window, start = %ld, end = %ld", (long)a_start, (long)a_end );
+        *a_fetchedEnd = a_end;
+        return true;
+    }
 
-	for (size_t i = 0; i < ItemsCount; i++) {
-		if (strcmp( Items[i].name, a_name ) == 0) {
-			result = Items + i;
-			break;
+    if (!isReused && !nvipfix_import_nvc_reopen( session, a_host, a_login, a_password )) {
+        return false;
+    }
+
+    bool (* pollFunc)( nvIPFIX_import_nvc_session_t *, nvIPFIX_import_nvc_poll_t * ) =
+    		(a_sink->recordFunc != NULL) ? nvipfix_import_nvc_poll_stream : nvipfix_import_nvc_poll;
+
+    if (a_deadline != 0 && nvipfix_import_nvc_deadline_start( &deadline )) {
+    	poll.deadline = &deadline;
+    }
+
+    bool isOk = pollFunc( session, &poll );
+
+    /*
+     * the switch may have dropped an idle session: reconnect once and repeat the poll,
+     * unless some records are exported already
+     */
+    if (!isOk && isReused && poll.handedCount == 0) {
+        nvipfix_log_warning( "%s: session lost, reconnecting", __func__ );
+
+        nvipfix_import_nvc_close( session );
+
+        poll.fetchedEnd = a_start;
+        isOk = nvipfix_import_nvc_reopen( session, a_host, a_login, a_password )
+                && pollFunc( session, &poll );
+    }
+
+    nvipfix_import_nvc_deadline_stop( poll.deadline );
+
+    if (poll.deadline != NULL && deadline.isExpired) {
+    	session->cancellationsCount++;
+    	nvipfix_log_warning( "%s: poll cancelled at the deadline, %zu part(s) exported, %ld s left to the next poll (%lu cancellation(s))",
+    			__func__, poll.handedCount, (long)(a_end - poll.fetchedEnd), session->cancellationsCount );
+    }
+
+    if (!isOk) {
+        nvipfix_import_nvc_close( session );
+    }
+
+    *a_fetchedEnd = poll.fetchedEnd;
+
+    return isOk;
+}
+
+time_t nvipfix_import_nvc_get_retry_time( void )
+{
+	return NvcSessions[0].retryTime;
+}
+
+/**
+ * open a session unless the last attempts failed recently (the delay doubles with each failure)
+ * @param a_session
+ * @param a_host
+ * @param a_login
+ * @param a_password
+ * @return
+ */
+bool nvipfix_import_nvc_reopen( nvIPFIX_import_nvc_session_t * a_session, const nvIPFIX_CHAR * a_host,
+		const nvIPFIX_CHAR * a_login, const nvIPFIX_CHAR * a_password )
+{
+	static bool isCleanupSet = false;
+
+	time_t now = time( NULL );
+
+	if (now < a_session->retryTime) {
+		nvipfix_log_warning( "%s: switch unavailable, next attempt in %d s", __func__, (int)(a_session->retryTime - now) );
+
+		return false;
+	}
+
+	bool result = nvipfix_import_nvc_open( a_session, a_host, a_login, a_password );
+
+	if (result) {
+		a_session->failuresCount = 0;
+		a_session->retryTime = 0;
+
+		if (!isCleanupSet) {
+			atexit( nvipfix_import_nvc_cleanup );
+			isCleanupSet = true;
+		}
+	}
+	else {
+		time_t delay = NvcRetryDelayMin;
+
+		for (unsigned i = 0; i < a_session->failuresCount && delay < NvcRetryDelayMax; i++) {
+			delay *= 2;
 		}
+
+		delay = (delay < NvcRetryDelayMax) ? delay : NvcRetryDelayMax;
+		a_session->failuresCount++;
+		a_session->retryTime = now + delay;
+
+		nvipfix_log_error( "%s: failed %u time(s), next attempt in %d s", __func__,
+				a_session->failuresCount, (int)delay );
 	}
 
 	return result;
 }
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-but-set-variable"
+/**
+ * connect and authenticate
+ * @param a_session
+ * @param a_host NULL for the local switch
+ * @param a_login NULL for the current user
+ * @param a_password
+ * @return
+ */
+bool nvipfix_import_nvc_open( nvIPFIX_import_nvc_session_t * a_session, const nvIPFIX_CHAR * a_host,
+		const nvIPFIX_CHAR * a_login, const nvIPFIX_CHAR * a_password )
+{
+    NVIPFIX_ERROR_INIT( error );
+
+    nvOS_io_t * io = &(a_session->io);
+
+    memset( io, 0, sizeof (nvOS_io_t) );
+
+    nvipfix_import_init();
+
+    if (a_host != NULL) {
+        nvc_init_net( io, NVIPFIX_CHAR_PTR_TO_CCHAR_PTR( a_host ) );
+    }
+    else {
+		nvc_init( io );
+    }
+
+    nvOS_result_t nvcResult = { 0 };
+    int nvcError;
+
+    nvcError = nvc_connect( io );
+    NVIPFIX_ERROR_RAISE_IF( nvcError != 0, error, NV_IPFIX_ERROR_CODE_NVC_CONNECT, Connect,
+        "nvc_connect: %d", nvcError );
+
+    if (a_login != NULL && a_password != NULL) {
+		nvcError = nvc_authenticate( io,
+				NVIPFIX_CHAR_PTR_TO_CCHAR_PTR( a_login ),
+				NVIPFIX_CHAR_PTR_TO_CCHAR_PTR( a_password ),
+				&nvcResult );
+    }
+    else {
+		char userName[nvc_PCL_NAME_LEN];
+		nvcError = nvc_check_uid( io, userName, sizeof userName, &nvcResult );
+    }
+
+    NVIPFIX_ERROR_RAISE_IF( nvcResult.res_status != nvOS_SUCCESS, error, NV_IPFIX_ERROR_CODE_NVC_AUTH, Auth,
+        "%s", nvcResult.res_msg );
+
+    NVIPFIX_ERROR_RAISE_IF( nvcError != 0, error, NV_IPFIX_ERROR_CODE_NVC_AUTH, Auth,
+        "nvc_authenticate/nvc_check_uid: %d", nvcError );
+
+    NVIPFIX_LOG_DEBUG( "session opened, host = %s", (a_host != NULL) ? a_host : "local" );
+    a_session->isOpen = true;
+
+    return true;
+
+    NVIPFIX_ERROR_HANDLER( Auth );
+    nvc_disconnect( io );
+
+    NVIPFIX_ERROR_HANDLER( Connect );
+    nvc_done( io );
+
+    return false;
+}
+
+/**
+ * query the whole window at once, if it holds more than a chunk split it into sub-windows (aggregated polls excepted)
+ * @param a_session
+ * @param a_poll
+ * @return
+ */
+bool nvipfix_import_nvc_poll( nvIPFIX_import_nvc_session_t * a_session, nvIPFIX_import_nvc_poll_t * a_poll )
+{
+	nvIPFIX_import_nvc_chunk_t chunk = { .start = a_poll->start, .end = a_poll->end, .poll = a_poll };
+
+	bool result = nvipfix_import_nvc_query( a_session, &chunk, a_poll->chunkSize );
+
+	if (result && chunk.isCancelled) {
+		/*
+		 * the window is polled again next time, its partial records would be exported twice
+		 */
+	}
+	else if (result && !nvipfix_import_nvc_check_split( a_session, &chunk )) {
+		if (chunk.list != NULL) {
+			a_poll->sink.chunkFunc( chunk.list, a_poll->sink.arg );
+			a_poll->handedCount++;
+		}
+
+		a_poll->fetchedEnd = a_poll->end;
+	}
+	else if (result && a_poll->sessionsCount > 1 && a_poll->end - a_poll->start > 1) {
+		NVIPFIX_LOG_DEBUG( "%zu connections or more, polling in sub-windows over %u sessions", chunk.rowsCount,
+				a_poll->sessionsCount );
+		result = nvipfix_import_nvc_poll_parallel( a_poll );
+	}
+	else if (result) {
+		NVIPFIX_LOG_DEBUG( "%zu connections or more, polling in sub-windows", chunk.rowsCount );
+		result = nvipfix_import_nvc_poll_window( a_session, a_poll, a_poll->start, a_poll->end );
+	}
+
+	nvipfix_data_list_free( chunk.list );
+
+	return result;
+}
+
+/**
+ * fetch [a_start, a_end), halving it until every part fits in a chunk; chunks are handed over in time order
+ * @param a_session
+ * @param a_poll
+ * @param a_start
+ * @param a_end
+ * @return
+ */
+bool nvipfix_import_nvc_poll_window( nvIPFIX_import_nvc_session_t * a_session, nvIPFIX_import_nvc_poll_t * a_poll,
+		time_t a_start, time_t a_end )
+{
+	nvIPFIX_import_nvc_chunk_t chunk = { .start = a_start, .end = a_end, .poll = a_poll };
+
+	bool result = nvipfix_import_nvc_query( a_session, &chunk, a_poll->chunkSize );
+
+	if (result && !chunk.isCancelled) {
+		if (nvipfix_import_nvc_check_split( a_session, &chunk )) {
+			time_t middle = a_start + (a_end - a_start) / 2;
+
+			nvipfix_data_list_free( chunk.list );
+			chunk.list = NULL;
+
+			result = nvipfix_import_nvc_poll_window( a_session, a_poll, a_start, middle )
+					&& nvipfix_import_nvc_poll_window( a_session, a_poll, middle, a_end );
+		}
+		else {
+			if (chunk.list != NULL) {
+				a_poll->sink.chunkFunc( chunk.list, a_poll->sink.arg );
+				a_poll->handedCount++;
+			}
+
+			a_poll->fetchedEnd = a_end;
+		}
+	}
+
+	nvipfix_data_list_free( chunk.list );
+
+	return result;
+}
+
+bool nvipfix_import_nvc_is_split_useful( time_t a_length, size_t a_rowsCount, size_t a_spanningCount,
+		nvIPFIX_U32 a_chunkSize, const nvIPFIX_conn_format_t * a_format )
+{
+	return a_rowsCount >= a_chunkSize && a_length > 1 && a_spanningCount < a_chunkSize
+			&& (a_format == NULL || a_format->sumBy == NULL);
+}
+
+/**
+ * whether a sub-window is split, the truncation is logged if the switch cut it at the limit and it is not
+ * @param a_session
+ * @param a_chunk
+ * @return
+ */
+bool nvipfix_import_nvc_check_split( nvIPFIX_import_nvc_session_t * a_session, const nvIPFIX_import_nvc_chunk_t * a_chunk )
+{
+	nvIPFIX_U32 limit = a_chunk->poll->chunkSize;
+
+	if (nvipfix_import_nvc_is_split_useful( a_chunk->end - a_chunk->start, a_chunk->rowsCount, a_chunk->spanningCount,
+			limit, a_chunk->poll->format )) {
+		return true;
+	}
+
+	if (a_chunk->rowsCount < limit) {
+		return false;
+	}
+
+	a_session->truncationsCount++;
+
+	if (a_chunk->poll->format != NULL && a_chunk->poll->format->sumBy != NULL) {
+		nvipfix_log_warning( "%s: more than %u aggregated rows in %ld s, the rest is lost (%lu truncation(s))",
+				__func__, (unsigned)limit, (long)(a_chunk->end - a_chunk->start), a_session->truncationsCount );
+	}
+	else {
+		nvipfix_log_warning( "%s: more than %u connections in %ld s (%zu running through it), the rest is lost (%lu truncation(s))",
+				__func__, (unsigned)limit, (long)(a_chunk->end - a_chunk->start), a_chunk->spanningCount,
+				a_session->truncationsCount );
+	}
+
+	return false;
+}
+
+/**
+ * split the window into sub-windows fetched concurrently, one session per thread. Each sub-window
+ * is collected in full, then handed over in time order; after a failure or a cancelled part nothing more is handed over
+ * @param a_poll
+ * @return
+ */
+bool nvipfix_import_nvc_poll_parallel( nvIPFIX_import_nvc_poll_t * a_poll )
+{
+	unsigned sessionsCount = 1;
+
+	while (sessionsCount < a_poll->sessionsCount
+			&& (NvcSessions[sessionsCount].isOpen
+					|| nvipfix_import_nvc_reopen( NvcSessions + sessionsCount, a_poll->host, a_poll->login, a_poll->password ))) {
+		sessionsCount++;
+	}
+
+	time_t length = a_poll->end - a_poll->start;
+	size_t partsCount = (size_t)sessionsCount * NvcPartsPerSession;
+
+	partsCount = (partsCount > (size_t)length) ? (size_t)length : partsCount;
+
+	bool result = true;
+
+	#pragma omp parallel for ordered schedule (dynamic, 1) num_threads (sessionsCount)
+	for (size_t i = 0; i < partsCount; i++) {
+#ifdef _OPENMP
+		nvIPFIX_import_nvc_session_t * session = NvcSessions + omp_get_thread_num();
+#else
+		nvIPFIX_import_nvc_session_t * session = NvcSessions;
+#endif
+		nvIPFIX_import_nvc_part_t part = { .chunks = NULL };
+		nvIPFIX_import_nvc_poll_t poll = *a_poll;
+
+		poll.sink.chunkFunc = nvipfix_import_nvc_collect_chunk;
+		poll.sink.arg = &part;
+
+		time_t partStart = a_poll->start + (time_t)(length * i / partsCount);
+		time_t partEnd = a_poll->start + (time_t)(length * (i + 1) / partsCount);
+
+		poll.fetchedEnd = partStart;
+
+		bool isOk = nvipfix_import_nvc_is_expired( a_poll->deadline )
+				|| (session->isOpen && nvipfix_import_nvc_poll_window( session, &poll, partStart, partEnd ));
+
+		/*
+		 * the first session is closed by the caller
+		 */
+		if (!isOk && session != NvcSessions) {
+			nvipfix_import_nvc_close( session );
+		}
+
+		#pragma omp ordered
+		{
+			/*
+			 * a part continues the window only if the parts before it were fetched in full, otherwise
+			 * it is polled again next time: handing it over now would export its records twice
+			 */
+			result = result && isOk && !part.isFailed;
+
+			bool isHanded = result && a_poll->fetchedEnd == partStart;
+
+			for (size_t j = 0; j < part.count; j++) {
+				if (isHanded) {
+					a_poll->sink.chunkFunc( part.chunks[j], a_poll->sink.arg );
+					a_poll->handedCount++;
+				}
+
+				nvipfix_data_list_free( part.chunks[j] );
+			}
+
+			if (isHanded) {
+				a_poll->fetchedEnd = poll.fetchedEnd;
+			}
+		}
+
+		free( part.chunks );
+	}
+
+	return result;
+}
+
+/**
+ * keep a chunk of a sub-window polled in parallel, its records are moved out of the list
+ * @param a_dataRecords
+ * @param a_arg nvIPFIX_import_nvc_part_t
+ */
+void nvipfix_import_nvc_collect_chunk( nvIPFIX_data_record_list_t * a_dataRecords, void * a_arg )
+{
+	nvIPFIX_import_nvc_part_t * part = a_arg;
+	nvIPFIX_data_record_list_t ** chunks = realloc( part->chunks, (part->count + 1) * sizeof (nvIPFIX_data_record_list_t *) );
+	nvIPFIX_data_record_list_t * list = malloc( sizeof (nvIPFIX_data_record_list_t) );
+
+	if (chunks != NULL) {
+		part->chunks = chunks;
+	}
+
+	if (chunks == NULL || list == NULL) {
+		nvipfix_log_error( "%s: memory allocation failed", __func__ );
+		part->isFailed = true;
+		free( list );
+
+		return;
+	}
+
+	*list = *a_dataRecords;
+	a_dataRecords->head = NULL;
+	a_dataRecords->tail = NULL;
+
+	part->chunks[part->count++] = list;
+}
+
+/**
+ * stream the records of the window to the sink as they arrive. A full sub-window cannot be
+ * fetched again without exporting records twice, so the number of sub-windows is planned:
+ * it doubles after a poll whose busiest sub-window came close to a chunk and halves after a quiet one.
+ * An aggregated poll is a single query, the sums of sub-windows would count spanning connections again
+ * @param a_session
+ * @param a_poll
+ * @return
+ */
+bool nvipfix_import_nvc_poll_stream( nvIPFIX_import_nvc_session_t * a_session, nvIPFIX_import_nvc_poll_t * a_poll )
+{
+	time_t length = a_poll->end - a_poll->start;
+	bool isAggregated = a_poll->format != NULL && a_poll->format->sumBy != NULL;
+	unsigned partsCount = (a_session->streamPartsCount > 0 && !isAggregated) ? a_session->streamPartsCount : 1;
+
+	if (length > 0 && partsCount > (unsigned long)length) {
+		partsCount = (unsigned)length;
+	}
+
+	size_t countMax = 0;
+	bool result = true;
+
+	for (unsigned i = 0; result && i < partsCount; i++) {
+		nvIPFIX_import_nvc_chunk_t chunk = {
+				.start = a_poll->start + length * i / partsCount,
+				.end = a_poll->start + length * (i + 1) / partsCount,
+				.poll = a_poll
+		};
+
+		size_t handedCount = a_poll->handedCount;
+
+		result = nvipfix_import_nvc_query( a_session, &chunk, a_poll->chunkSize );
+		countMax = (chunk.rowsCount > countMax) ? chunk.rowsCount : countMax;
+
+		if (result && !chunk.isCancelled) {
+			a_poll->fetchedEnd = chunk.end;
+		}
+		else if (a_poll->handedCount > handedCount) {
+			/*
+			 * the records streamed so far are exported already, polling the sub-window again
+			 * would export them twice: it is skipped, its remaining connections are lost
+			 */
+			nvipfix_log_warning( "%s: sub-window [%ld, %ld) cut off after %zu connections, the rest is lost",
+					__func__, (long)chunk.start, (long)chunk.end, a_poll->handedCount - handedCount );
+			a_poll->fetchedEnd = chunk.end;
+		}
+
+		if (result && chunk.rowsCount >= a_poll->chunkSize) {
+			a_session->truncationsCount++;
+			nvipfix_log_warning( "%s: more than %u connections in a sub-window, the rest is lost (%lu truncation(s))",
+					__func__, (unsigned)a_poll->chunkSize, a_session->truncationsCount );
+		}
+	}
+
+	if (nvipfix_import_nvc_is_expired( a_poll->deadline ) || isAggregated) {
+		/*
+		 * the sub-windows after the deadline say nothing about the load
+		 */
+	}
+	else if (result && countMax >= a_poll->chunkSize - a_poll->chunkSize / 4) {
+		partsCount *= 2;
+	}
+	else if (result && countMax < a_poll->chunkSize / 4 && partsCount > 1) {
+		partsCount /= 2;
+	}
+
+	a_session->streamPartsCount = partsCount;
+
+	return result;
+}
+
+/**
+ *
+ * @param a_session
+ * @param a_chunk [in, out] sub-window
+ * @param a_limit maximum number of connections
+ * @return false if the query failed (a_chunk may hold records received before the failure);
+ * true with the records received so far if the poll's deadline passed
+ */
+bool nvipfix_import_nvc_query( nvIPFIX_import_nvc_session_t * a_session, nvIPFIX_import_nvc_chunk_t * a_chunk,
+		nvIPFIX_U32 a_limit )
+{
+    NVIPFIX_ERROR_INIT( error );
+
+    nvOS_result_t nvcResult = { 0 };
+    int nvcError;
+
+    nvc_conn_t filter = { { 0 } };
+    uint64_t filterFields = 0;
+
+    filter.conn_args.start_time = a_chunk->start;
+    filter.conn_args.end_time = a_chunk->end;
+    nvc_FIELD_FLAG_SET( filterFields, nvc_stats_args_start_time );
+    nvc_FIELD_FLAG_SET( filterFields, nvc_stats_args_end_time );
+
+    nvipfix_import_nvc_set_filter( &filter, &filterFields, a_chunk->poll->filter );
+
+    nvc_format_args_t format = { { 0 } };
+    uint64_t formatFields = 0;
+    format.limit_output = a_limit;
+    nvc_FIELD_FLAG_SET( formatFields, nvc_format_args_limit_output );
+
+    nvipfix_import_nvc_set_format( &format, &formatFields, a_chunk->poll->format );
+
+    nvIPFIX_import_nvc_deadline_t * deadline = a_chunk->poll->deadline;
+
+    if (nvipfix_import_nvc_is_expired( deadline )) {
+    	a_chunk->isCancelled = true;
+    	return true;
+    }
+
+    NVIPFIX_LOG_DEBUG( "start = %ld, end = %ld", (long)a_chunk->start, (long)a_chunk->end );
+
+#ifdef NVIPFIX_IMPORT_USE_NVC_WATCHDOG
+    if (deadline != NULL) {
+    	pthread_mutex_lock( &(deadline->mutex) );
+    	a_session->isQuerying = true;
+    	pthread_mutex_unlock( &(deadline->mutex) );
+    }
+#endif
+
+    nvcError = nvc_show_conn_stat( &(a_session->io),
+        filterFields, &filter,
+        formatFields, &format,
+        nvipfix_import_conn_stat_handler, a_chunk,
+		&nvcResult );
+
+#ifdef NVIPFIX_IMPORT_USE_NVC_WATCHDOG
+    if (deadline != NULL) {
+    	pthread_mutex_lock( &(deadline->mutex) );
+    	a_session->isQuerying = false;
+    	pthread_mutex_unlock( &(deadline->mutex) );
+    }
+#endif
+
+    /*
+     * the rest of a cancelled reply may still be on its way: the session cannot even carry a logout
+     */
+    if (nvipfix_import_nvc_is_expired( deadline )) {
+    	NVIPFIX_LOG_DEBUG( "cancelled, %zu connection(s) received", a_chunk->rowsCount );
+    	a_chunk->isCancelled = true;
+    	a_session->isBroken = true;
+    	nvipfix_import_nvc_close( a_session );
+
+    	return true;
+    }
+
+    NVIPFIX_ERROR_RAISE_IF( nvcResult.res_status != nvOS_SUCCESS, error, NV_IPFIX_ERROR_CODE_NVC_CONN_STAT, ConnStat,
+        "%s", nvcResult.res_msg );
+
+    NVIPFIX_ERROR_RAISE_IF( nvcError != 0, error, NV_IPFIX_ERROR_CODE_NVC_CONN_STAT, ConnStat,
+        "nvc_show_conn_stat: %d", nvcError );
+
+    return true;
+
+    NVIPFIX_ERROR_HANDLER( ConnStat );
+
+    return false;
+}
+#pragma GCC diagnostic pop
+
+/**
+ * let the switch drop the connections nothing is exported for
+ * @param a_conn [out]
+ * @param a_fields [in, out] nvc_conn_t field flags
+ * @param a_filter
+ */
+void nvipfix_import_nvc_set_filter( nvc_conn_t * a_conn, uint64_t * a_fields, const nvIPFIX_conn_filter_t * a_filter )
+{
+	if (a_filter == NULL) {
+		return;
+	}
+
+	if (a_filter->vlan >= 0) {
+		a_conn->conn_vlan = (nvc_pcl_vlan_id_t)a_filter->vlan;
+		nvc_FIELD_FLAG_SET( *a_fields, nvc_conn_vlan );
+	}
+
+	if (a_filter->vnet != NULL) {
+		strncpy( a_conn->conn_vnet, a_filter->vnet, sizeof a_conn->conn_vnet - 1 );
+		nvc_FIELD_FLAG_SET( *a_fields, nvc_conn_vnet );
+	}
+
+	if (a_filter->clientPort >= 0) {
+		a_conn->conn_client_port = (nvc_service_port_type_t)a_filter->clientPort;
+		nvc_FIELD_FLAG_SET( *a_fields, nvc_conn_client_port );
+	}
+
+	if (a_filter->serverPort >= 0) {
+		a_conn->conn_server_port = (nvc_service_port_type_t)a_filter->serverPort;
+		nvc_FIELD_FLAG_SET( *a_fields, nvc_conn_server_port );
+	}
+
+	if (a_filter->protocol >= 0) {
+		a_conn->conn_proto = (nvc_ip_protocol_t)a_filter->protocol;
+		nvc_FIELD_FLAG_SET( *a_fields, nvc_conn_proto );
+	}
+}
+
+/**
+ * let the switch sum up and sort the connections
+ * @param a_args [out]
+ * @param a_fields [in, out] nvc_format_args_t field flags
+ * @param a_format
+ */
+void nvipfix_import_nvc_set_format( nvc_format_args_t * a_args, uint64_t * a_fields, const nvIPFIX_conn_format_t * a_format )
+{
+	if (a_format == NULL) {
+		return;
+	}
+
+	if (a_format->sumBy != NULL) {
+		strncpy( a_args->sum_by, a_format->sumBy, sizeof a_args->sum_by - 1 );
+		nvc_FIELD_FLAG_SET( *a_fields, nvc_format_args_sum_by );
+	}
+
+	if (a_format->sortAsc != NULL) {
+		strncpy( a_args->sort_asc, a_format->sortAsc, sizeof a_args->sort_asc - 1 );
+		nvc_FIELD_FLAG_SET( *a_fields, nvc_format_args_sort_asc );
+	}
+
+	if (a_format->sortDesc != NULL) {
+		strncpy( a_args->sort_desc, a_format->sortDesc, sizeof a_args->sort_desc - 1 );
+		nvc_FIELD_FLAG_SET( *a_fields, nvc_format_args_sort_desc );
+	}
+}
+
+bool nvipfix_import_nvc_is_expired( nvIPFIX_import_nvc_deadline_t * a_deadline )
+{
+	if (a_deadline == NULL) {
+		return false;
+	}
+
+	if (!a_deadline->isExpired && time( NULL ) >= a_deadline->time) {
+		a_deadline->isExpired = true;
+	}
+
+	return a_deadline->isExpired;
+}
+
+/**
+ * start the watchdog of a poll, without it the deadline is only checked as records arrive
+ * @param a_deadline
+ * @return false if the poll is to run without a deadline
+ */
+bool nvipfix_import_nvc_deadline_start( nvIPFIX_import_nvc_deadline_t * a_deadline )
+{
+#ifdef NVIPFIX_IMPORT_USE_NVC_WATCHDOG
+	a_deadline->isDone = false;
+
+	if (pthread_mutex_init( &(a_deadline->mutex), NULL ) != 0) {
+		nvipfix_log_error( "%s: pthread_mutex_init failed, polling without a deadline", __func__ );
+
+		return false;
+	}
+
+	if (pthread_cond_init( &(a_deadline->cond), NULL ) != 0) {
+		nvipfix_log_error( "%s: pthread_cond_init failed, polling without a deadline", __func__ );
+		pthread_mutex_destroy( &(a_deadline->mutex) );
+
+		return false;
+	}
+
+	if (pthread_create( &(a_deadline->thread), NULL, nvipfix_import_nvc_watchdog, a_deadline ) != 0) {
+		nvipfix_log_error( "%s: pthread_create failed, polling without a deadline", __func__ );
+		pthread_cond_destroy( &(a_deadline->cond) );
+		pthread_mutex_destroy( &(a_deadline->mutex) );
+
+		return false;
+	}
+#endif
+
+	return true;
+}
+
+void nvipfix_import_nvc_deadline_stop( nvIPFIX_import_nvc_deadline_t * a_deadline )
+{
+	NVIPFIX_NULL_ARGS_GUARD_1_VOID( a_deadline );
+
+#ifdef NVIPFIX_IMPORT_USE_NVC_WATCHDOG
+	pthread_mutex_lock( &(a_deadline->mutex) );
+	a_deadline->isDone = true;
+	pthread_cond_signal( &(a_deadline->cond) );
+	pthread_mutex_unlock( &(a_deadline->mutex) );
+
+	pthread_join( a_deadline->thread, NULL );
+
+	pthread_cond_destroy( &(a_deadline->cond) );
+	pthread_mutex_destroy( &(a_deadline->mutex) );
+#endif
+}
+
+#ifdef NVIPFIX_IMPORT_USE_NVC_WATCHDOG
+/**
+ * wait for the deadline, then cancel the queries in progress through nvOS_io_t::cancel_func
+ * @param a_arg nvIPFIX_import_nvc_deadline_t
+ * @return
+ */
+void * nvipfix_import_nvc_watchdog( void * a_arg )
+{
+	nvIPFIX_import_nvc_deadline_t * deadline = a_arg;
+	struct timespec time = { .tv_sec = deadline->time, .tv_nsec = 0 };
+	int error = 0;
+
+	pthread_mutex_lock( &(deadline->mutex) );
+
+	while (!deadline->isDone && error != ETIMEDOUT) {
+		error = pthread_cond_timedwait( &(deadline->cond), &(deadline->mutex), &time );
+	}
+
+	if (!deadline->isDone) {
+		deadline->isExpired = true;
+
+		for (size_t i = 0; i < NvcSessionsMax; i++) {
+			nvOS_io_t * io = &(NvcSessions[i].io);
+
+			if (NvcSessions[i].isQuerying && io->cancel_func != NULL) {
+				io->cancel_func( io->cancel_arg );
+			}
+		}
+	}
+
+	pthread_mutex_unlock( &(deadline->mutex) );
+
+	return NULL;
+}
+#endif
+
+void nvipfix_import_nvc_close( nvIPFIX_import_nvc_session_t * a_session )
+{
+	if (a_session->isOpen) {
+		if (!a_session->isBroken) {
+			nvc_logout( &(a_session->io) );
+		}
+
+		nvc_disconnect( &(a_session->io) );
+		nvc_done( &(a_session->io) );
+
+		a_session->isOpen = false;
+		a_session->isBroken = false;
+	}
+}
+
+void nvipfix_import_nvc_cleanup( void )
+{
+	for (size_t i = 0; i < NvcSessionsMax; i++) {
+		nvipfix_import_nvc_close( NvcSessions + i );
+	}
+}
+
+#endif
+
+bool nvipfix_import_parse_ingress( const char * a_s, void * a_value )
+{
+	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
+
+	return nvipfix_parse_u32( a_s, a_value );
+}
+
+bool nvipfix_import_parse_egress( const char * a_s, void * a_value )
+{
+	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
+
+	return nvipfix_parse_u32( a_s, a_value );
+}
+
+bool nvipfix_import_parse_layer2( const char * a_s, void * a_value )
+{
+	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
+
+	bool result = nvipfix_parse_u64( a_s, a_value );
+
+	if (result) {
+		nvIPFIX_U64 * u64Ptr = a_value;
+		*u64Ptr |= ((nvIPFIX_U64)NV_IPFIX_LAYER2_NETWORK_TYPE_VxLAN << 56);
+	}
+
+	return result;
+}
+
+bool nvipfix_import_parse_tcp_control_flags( const char * a_s, void * a_value )
+{
+	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
+
+	bool result = true;
+	nvIPFIX_TCP_CONTROL_FLAG * flagPtr = a_value;
+
+	if (strcmp( "fin", a_s ) == 0) {
+		*flagPtr = NV_IPFIX_TCP_CONTROL_FLAG_FIN;
+	}
+	else if (strcmp( "rst", a_s ) == 0) {
+		*flagPtr = NV_IPFIX_TCP_CONTROL_FLAG_RST;
+	}
+	else if (strcmp( "syn", a_s ) == 0) {
+		*flagPtr = NV_IPFIX_TCP_CONTROL_FLAG_SYN;
+	}
+	else if (strcmp( "est", a_s ) == 0) {
+		*flagPtr = NV_IPFIX_TCP_CONTROL_FLAG_ACK;
+	}
+	else {
+		result = false;
+	}
+
+	return result;
+}
+
+bool nvipfix_import_parse_protocol( const char * a_s, void * a_value )
+{
+	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
+
+	nvIPFIX_OCTET protocol;
+	bool result = true;
+
+	/*
+	 * CLI output names the protocol
+	 */
+	if (strcmp( "tcp", a_s ) == 0) {
+		protocol = NV_IPFIX_PROTOCOL_TCP;
+	}
+	else if (strcmp( "udp", a_s ) == 0) {
+		protocol = NV_IPFIX_PROTOCOL_UDP;
+	}
+	else if (strcmp( "icmp", a_s ) == 0) {
+		protocol = NV_IPFIX_PROTOCOL_ICMP;
+	}
+	else {
+		result = nvipfix_parse_octet( a_s, &protocol );
+	}
+
+	if (result) {
+		*((nvIPFIX_PROTOCOL *)a_value) = (nvIPFIX_PROTOCOL)protocol;
+	}
+
+	return result;
+}
+
+bool nvipfix_import_parse_ethernet_type( const char * a_s, void * a_value )
+{
+	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
+
+	nvIPFIX_U16 type;
+	bool result = nvipfix_parse_u16( a_s, &type );
+
+	if (result) {
+		*((nvIPFIX_ETHERNET_TYPE *)a_value) = (nvIPFIX_ETHERNET_TYPE)type;
+	}
+
+	return result;
+}
+
+void nvipfix_import_init( void )
+{
+	static volatile bool isInitialized = false;
+
+	if (isInitialized) {
+		return;
+	}
+
+	#pragma omp critical (nvipfixCritical_ImportInit)
+	{
+		if (!isInitialized) {
+#ifdef NVIPFIX_DEF_ENABLE_NVC
+			CRYPTO_malloc_init();
+			SSL_library_init();
+			SSL_load_error_strings();
+			ERR_load_BIO_strings();
+			OpenSSL_add_all_algorithms();
+#endif
+
+			IsItemsIndexPerfect = true;
+
+			for (size_t i = 0; i < ItemsCount; i++) {
+				size_t slot = NVIPFIX_IMPORT_ITEM_HASH( Items[i].name, Items[i].nameLen );
+
+				if (ItemsIndex[slot] != NULL) {
+					nvipfix_log_warning( "%s: items '%s' and '%s' collide, using linear lookup",
+							__func__, ItemsIndex[slot]->name, Items[i].name );
+					IsItemsIndexPerfect = false;
+				}
+
+				ItemsIndex[slot] = Items + i;
+			}
+
+#ifdef NVIPFIX_IMPORT_USE_AVX2
+			__builtin_cpu_init();
+
+			if (__builtin_cpu_supports( "avx2" )) {
+				IndexBlock = nvipfix_import_index_block_avx2;
+			}
+#endif
+
+			isInitialized = true;
+		}
+	}
+}
+
+const nvIPFIX_import_item_t * nvipfix_import_get_item( const nvIPFIX_string_span_t * a_name )
+{
+	const nvIPFIX_import_item_t * result = NULL;
+
+	if (IsItemsIndexPerfect) {
+		if (a_name->len >= 2) {
+			const nvIPFIX_import_item_t * item = ItemsIndex[NVIPFIX_IMPORT_ITEM_HASH( a_name->value, a_name->len )];
+
+			if (item != NULL && item->nameLen == a_name->len && memcmp( item->name, a_name->value, a_name->len ) == 0) {
+				result = item;
+			}
+		}
+	}
+	else {
+		for (size_t i = 0; i < ItemsCount; i++) {
+			if (Items[i].nameLen == a_name->len && memcmp( Items[i].name, a_name->value, a_name->len ) == 0) {
+				result = Items + i;
+				break;
+			}
+		}
+	}
+
+	return result;
+}
+
+#ifdef NVIPFIX_DEF_POSIX
+/**
+ * map a regular file read-only for sequential parsing
+ * @param a_fileName
+ * @param a_len [out] mapping length
+ * @return mapping or NULL if the file cannot be mapped (not a regular file, empty, etc.)
+ */
+void * nvipfix_import_map_file( const nvIPFIX_CHAR * a_fileName, size_t * a_len )
+{
+	void * result = NULL;
+	int fd = open( a_fileName, O_RDONLY );
+
+	if (fd >= 0) {
+		struct stat fileStat;
+
+		if (fstat( fd, &fileStat ) == 0 && S_ISREG( fileStat.st_mode ) && fileStat.st_size > 0) {
+			result = mmap( NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+			if (result != MAP_FAILED) {
+				*a_len = (size_t)fileStat.st_size;
+
+				posix_madvise( result, *a_len, POSIX_MADV_SEQUENTIAL );
+#ifdef MADV_HUGEPAGE
+				madvise( result, *a_len, MADV_HUGEPAGE );
+#endif
+			}
+			else {
+				NVIPFIX_LOG_DEBUG( "mmap '%s' failed, falling back to read", a_fileName );
+				result = NULL;
+			}
+		}
+
+		close( fd );
+	}
+
+	return result;
+}
+#endif
+
+#ifndef NVIPFIX_IMPORT_USE_SSE2
+/**
+ * build quote and structural character bitmasks of a block (scalar version)
+ * @param a_block SizeofBlock bytes
+ * @param a_quoteBits
+ * @param a_structuralBits
+ */
+void nvipfix_import_index_block( const nvIPFIX_CHAR * a_block, uint64_t * a_quoteBits, uint64_t * a_structuralBits )
+{
+	uint64_t quoteBits = 0;
+	uint64_t structuralBits = 0;
+
+	for (size_t i = 0; i < SizeofBlock; i++) {
+		nvIPFIX_CHAR ch = a_block[i];
+
+		quoteBits |= (uint64_t)(ch == '"') << i;
+		structuralBits |= (uint64_t)(ch == ':' || ch == ',' || ch == '{' || ch == '}' || ch == '[' || ch == ']') << i;
+	}
+
+	*a_quoteBits = quoteBits;
+	*a_structuralBits = structuralBits;
+}
+#endif
+
+#ifdef NVIPFIX_IMPORT_USE_SSE2
+/*
+ * brackets and braces differ from each other by 0x20 only: (ch | 0x20) is '{' for '[' and '{', '}' for ']' and '}'
+ */
+void nvipfix_import_index_block_sse2( const nvIPFIX_CHAR * a_block, uint64_t * a_quoteBits, uint64_t * a_structuralBits )
+{
+	const __m128i quote = _mm_set1_epi8( '"' );
+	const __m128i colon = _mm_set1_epi8( ':' );
+	const __m128i comma = _mm_set1_epi8( ',' );
+	const __m128i openBrace = _mm_set1_epi8( '{' );
+	const __m128i closeBrace = _mm_set1_epi8( '}' );
+	const __m128i caseBit = _mm_set1_epi8( 0x20 );
+
+	uint64_t quoteBits = 0;
+	uint64_t structuralBits = 0;
+
+	for (size_t i = 0; i < SizeofBlock; i += sizeof (__m128i)) {
+		__m128i chars = _mm_loadu_si128( (const __m128i *)(a_block + i) );
+		__m128i folded = _mm_or_si128( chars, caseBit );
+
+		__m128i structurals = _mm_or_si128(
+				_mm_or_si128( _mm_cmpeq_epi8( chars, colon ), _mm_cmpeq_epi8( chars, comma ) ),
+				_mm_or_si128( _mm_cmpeq_epi8( folded, openBrace ), _mm_cmpeq_epi8( folded, closeBrace ) ) );
+
+		quoteBits |= (uint64_t)(uint16_t)_mm_movemask_epi8( _mm_cmpeq_epi8( chars, quote ) ) << i;
+		structuralBits |= (uint64_t)(uint16_t)_mm_movemask_epi8( structurals ) << i;
+	}
+
+	*a_quoteBits = quoteBits;
+	*a_structuralBits = structuralBits;
+}
+#endif
+
+#ifdef NVIPFIX_IMPORT_USE_AVX2
+void nvipfix_import_index_block_avx2( const nvIPFIX_CHAR * a_block, uint64_t * a_quoteBits, uint64_t * a_structuralBits )
+{
+	const __m256i quote = _mm256_set1_epi8( '"' );
+	const __m256i colon = _mm256_set1_epi8( ':' );
+	const __m256i comma = _mm256_set1_epi8( ',' );
+	const __m256i openBrace = _mm256_set1_epi8( '{' );
+	const __m256i closeBrace = _mm256_set1_epi8( '}' );
+	const __m256i caseBit = _mm256_set1_epi8( 0x20 );
+
+	uint64_t quoteBits = 0;
+	uint64_t structuralBits = 0;
+
+	for (size_t i = 0; i < SizeofBlock; i += sizeof (__m256i)) {
+		__m256i chars = _mm256_loadu_si256( (const __m256i *)(a_block + i) );
+		__m256i folded = _mm256_or_si256( chars, caseBit );
+
+		__m256i structurals = _mm256_or_si256(
+				_mm256_or_si256( _mm256_cmpeq_epi8( chars, colon ), _mm256_cmpeq_epi8( chars, comma ) ),
+				_mm256_or_si256( _mm256_cmpeq_epi8( folded, openBrace ), _mm256_cmpeq_epi8( folded, closeBrace ) ) );
+
+		quoteBits |= (uint64_t)(uint32_t)_mm256_movemask_epi8( _mm256_cmpeq_epi8( chars, quote ) ) << i;
+		structuralBits |= (uint64_t)(uint32_t)_mm256_movemask_epi8( structurals ) << i;
+	}
+
+	*a_quoteBits = quoteBits;
+	*a_structuralBits = structuralBits;
+}
+#endif
+
+/**
+ * find next quote or structural character using the block index
+ * @param a_parser
+ * @param a_s position to search from
+ * @param a_isQuote search for '"' if true, for structural characters otherwise
+ * @return pointer to the character or NULL if there is none before the end of the buffer
+ */
+const nvIPFIX_CHAR * nvipfix_import_scan( nvIPFIX_import_parser_t * a_parser, const nvIPFIX_CHAR * a_s, bool a_isQuote )
+{
+	while (a_s < a_parser->end) {
+		if (a_parser->block == NULL || a_s < a_parser->block || a_s >= a_parser->block + SizeofBlock) {
+			size_t len = a_parser->end - a_s;
+
+			if (len >= SizeofBlock) {
+				IndexBlock( a_s, &(a_parser->quoteBits), &(a_parser->structuralBits) );
+			}
+			else {
+				nvIPFIX_CHAR block[SizeofBlock] = { 0 };
+
+				memcpy( block, a_s, len );
+				IndexBlock( block, &(a_parser->quoteBits), &(a_parser->structuralBits) );
+			}
+
+			a_parser->block = a_s;
+		}
+
+		uint64_t bits = (a_isQuote ? a_parser->quoteBits : a_parser->structuralBits) >> (a_s - a_parser->block);
+
+		if (bits != 0) {
+			return a_s + __builtin_ctzll( bits );
+		}
+
+		a_s = a_parser->block + SizeofBlock;
+	}
+
+	return NULL;
+}
+
+/**
+ * find closing quote of a string using the block index, skipping escaped quotes
+ * @param a_parser
+ * @param a_s first character after the opening quote
+ * @return pointer to the closing quote or NULL if the string is not terminated
+ */
+const nvIPFIX_CHAR * nvipfix_import_scan_quote( nvIPFIX_import_parser_t * a_parser, const nvIPFIX_CHAR * a_s )
+{
+	const nvIPFIX_CHAR * result = NULL;
+	const nvIPFIX_CHAR * start = a_s;
+
+	while ((result = nvipfix_import_scan( a_parser, a_s, true )) != NULL) {
+		size_t escapes = 0;
+
+		while (result - escapes > start && result[-1 - (ptrdiff_t)escapes] == '\\') {
+			escapes++;
+		}
+
+		if ((escapes & 1) == 0) {
+			break;
+		}
+
+		a_s = result + 1;
+	}
+
+	return result;
+}
+
+const nvIPFIX_CHAR * nvipfix_import_skip_whitespace( const nvIPFIX_CHAR * a_s, const nvIPFIX_CHAR * a_end )
+{
+	while (a_s < a_end && NVIPFIX_IMPORT_IS_WHITESPACE( *a_s )) {
+		a_s++;
+	}
+
+	return a_s;
+}
+
+/**
+ * skip whitespace and commas between records
+ * @param a_s
+ * @param a_end
+ * @return
+ */
+const nvIPFIX_CHAR * nvipfix_import_skip_separators( const nvIPFIX_CHAR * a_s, const nvIPFIX_CHAR * a_end )
+{
+	while (a_s < a_end && (*a_s == ',' || NVIPFIX_IMPORT_IS_WHITESPACE( *a_s ))) {
+		a_s++;
+	}
+
+	return a_s;
+}
+
+/**
+ * skip empty lines between rows of delimited input
+ * @param a_s
+ * @param a_end
+ * @return
+ */
+const nvIPFIX_CHAR * nvipfix_import_skip_newlines( const nvIPFIX_CHAR * a_s, const nvIPFIX_CHAR * a_end )
+{
+	while (a_s < a_end && (*a_s == '\n' || *a_s == '\r')) {
+		a_s++;
+	}
+
+	return a_s;
+}
+
+/**
+ * find closing quote of a string, skipping escaped quotes
+ * @param a_s first character after the opening quote
+ * @param a_end
+ * @return pointer to the closing quote or NULL if the string is not terminated
+ */
+const nvIPFIX_CHAR * nvipfix_import_find_quote( const nvIPFIX_CHAR * a_s, const nvIPFIX_CHAR * a_end )
+{
+	const nvIPFIX_CHAR * result = NULL;
+
+	while (a_s < a_end) {
+		const nvIPFIX_CHAR * quote = memchr( a_s, '"', a_end - a_s );
+
+		if (quote == NULL) {
+			break;
+		}
+
+		size_t escapes = 0;
+
+		while (quote - escapes > a_s && quote[-1 - (ptrdiff_t)escapes] == '\\') {
+			escapes++;
+		}
+
+		if ((escapes & 1) == 0) {
+			result = quote;
+			break;
+		}
+
+		a_s = quote + 1;
+	}
+
+	return result;
+}
+
+/**
+ * skip nested object or array value
+ * @param a_s pointer to the opening bracket
+ * @param a_end
+ * @return pointer past the closing bracket or NULL if the value is not terminated
+ */
+const nvIPFIX_CHAR * nvipfix_import_skip_nested( const nvIPFIX_CHAR * a_s, const nvIPFIX_CHAR * a_end )
+{
+	size_t depth = 0;
+
+	while (a_s < a_end) {
+		nvIPFIX_CHAR ch = *a_s++;
+
+		if (ch == '"') {
+			a_s = nvipfix_import_find_quote( a_s, a_end );
+
+			if (a_s == NULL) {
+				break;
+			}
+
+			a_s++;
+		}
+		else if (ch == '{' || ch == '[') {
+			depth++;
+		}
+		else if ((ch == '}' || ch == ']') && --depth == 0) {
+			return a_s;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * position parser at the first record of the "data" array,
+ * or at the first row if the input is not JSON (delimited CLI output)
+ * @param a_parser
+ * @return
+ */
+bool nvipfix_import_find_records( nvIPFIX_import_parser_t * a_parser )
+{
+	bool result = false;
+	const nvIPFIX_CHAR * s = a_parser->cursor;
+	const nvIPFIX_CHAR * end = a_parser->end;
+	const nvIPFIX_CHAR * first = nvipfix_import_skip_whitespace( s, end );
+
+	if (first < end && *first != '{') {
+		return nvipfix_import_find_header( a_parser );
+	}
+
+	while (!result && s < end) {
+		s = memchr( s, '"', end - s );
+
+		if (s == NULL) {
+			break;
+		}
+
+		const nvIPFIX_CHAR * name = s + 1;
+		const nvIPFIX_CHAR * quote = nvipfix_import_find_quote( name, end );
+
+		if (quote == NULL) {
+			break;
+		}
+
+		s = quote + 1;
+
+		if ((size_t)(quote - name) == (sizeof RecordsName) - 1
+				&& memcmp( name, RecordsName, (sizeof RecordsName) - 1 ) == 0) {
+			const nvIPFIX_CHAR * next = nvipfix_import_skip_whitespace( s, end );
+
+			if (next < end && *next == ':') {
+				next = nvipfix_import_skip_whitespace( next + 1, end );
+
+				if (next < end && *next == '[') {
+					a_parser->cursor = next + 1;
+					result = true;
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+/**
+ * resolve the header line of delimited input into columns
+ * the delimiter is the first character of the header that cannot be part of an item name, except those found in
+ * MAC addresses, IP addresses and times: columns are not quoted, such a delimiter would cut the values
+ * @param a_parser
+ * @return false if the header line is not complete yet
+ */
+bool nvipfix_import_find_header( nvIPFIX_import_parser_t * a_parser )
+{
+	const nvIPFIX_CHAR * s = nvipfix_import_skip_whitespace( a_parser->cursor, a_parser->end );
+	const nvIPFIX_CHAR * end = a_parser->end;
+	const nvIPFIX_CHAR * eol = memchr( s, '\n', end - s );
+
+	if (eol == NULL) {
+		if (!a_parser->isLast) {
+			return false;
+		}
+
+		eol = end;
+	}
+
+	const nvIPFIX_CHAR * lineEnd = (eol > s && eol[-1] == '\r') ? eol - 1 : eol;
+	nvIPFIX_CHAR delimiter = ',';
+
+	for (const nvIPFIX_CHAR * ch = s; ch < lineEnd; ch++) {
+		if (!((*ch >= 'a' && *ch <= 'z') || (*ch >= 'A' && *ch <= 'Z') || (*ch >= '0' && *ch <= '9')
+				|| *ch == '-' || *ch == '_')) {
+			if (*ch != ':' && *ch != '.' && *ch != '+') {
+				delimiter = *ch;
+			}
+			else {
+				nvipfix_log_warning( "%s: '%c' cannot delimit columns, ',' assumed", __func__, *ch );
+			}
+
+			break;
+		}
+	}
+
+	a_parser->columnsCount = 0;
+
+	while (a_parser->columnsCount < SizeofColumns) {
+		const nvIPFIX_CHAR * next = memchr( s, delimiter, lineEnd - s );
+		nvIPFIX_string_span_t name = { .value = s, .len = ((next != NULL) ? next : lineEnd) - s };
+		const nvIPFIX_import_item_t * item = nvipfix_import_get_item( &name );
+
+		if (item == NULL) {
+			nvipfix_log_warning( "%s: unknown column = '%.*s'", __func__, (int)name.len, name.value );
+		}
+		else if ((a_parser->fields & item->dataField) == 0) {
+			item = NULL;
+		}
+
+		a_parser->columns[a_parser->columnsCount++] = item;
+
+		if (next == NULL) {
+			break;
+		}
+
+		s = next + 1;
+	}
+
+	NVIPFIX_LOG_DEBUG0( "columns count = %u, delimiter = '%c'", (unsigned)a_parser->columnsCount, delimiter );
+
+	a_parser->delimiter = delimiter;
+	a_parser->cursor = (eol < end) ? eol + 1 : end;
+
+	return true;
+}
+
+/**
+ * guess where a record starts at or after a_s: '}' [ws] ',' [ws] '{'
+ * a lookalike inside a string or a nested value is possible, chunk parsing verifies the guess
+ * rows of delimited input start after a newline, no guessing needed
+ * @param a_parser
+ * @param a_s
+ * @param a_end
+ * @return '{' of the record, first character of the row or NULL
+ */
+const nvIPFIX_CHAR * nvipfix_import_find_boundary( const nvIPFIX_import_parser_t * a_parser,
+		const nvIPFIX_CHAR * a_s, const nvIPFIX_CHAR * a_end )
+{
+	const nvIPFIX_CHAR * result = NULL;
+	const nvIPFIX_CHAR * s = a_s;
+
+	if (a_parser->delimiter != '\0') {
+		s = memchr( s, '\n', a_end - s );
+
+		if (s != NULL) {
+			s = nvipfix_import_skip_newlines( s, a_end );
+			result = (s < a_end) ? s : NULL;
+		}
+
+		return result;
+	}
+
+	while (result == NULL && s < a_end && (s = memchr( s, '}', a_end - s )) != NULL) {
+		s = nvipfix_import_skip_whitespace( s + 1, a_end );
+
+		if (s < a_end && *s == ',') {
+			s = nvipfix_import_skip_whitespace( s + 1, a_end );
+
+			if (s < a_end && *s == '{') {
+				result = s;
+			}
+		}
+	}
+
+	return result;
+}
+
+/**
+ * parse the "data" array in chunks on all threads, chunk lists are joined in input order
+ * @param a_parser positioned at the first record
+ * @param a_stop record start to stop at (NULL to parse up to the end of the array)
+ * @param a_list
+ * @param a_count
+ * @return false if the input is too small to split or a chunk did not end where the next one starts
+ * 	(nothing is added then)
+ */
+bool nvipfix_import_parse_chunks( const nvIPFIX_import_parser_t * a_parser, const nvIPFIX_CHAR * a_stop,
+		nvIPFIX_data_record_list_t * * a_list, size_t * a_count )
+{
+	bool result = false;
+
+#ifdef _OPENMP
+	const nvIPFIX_CHAR * end = (a_stop != NULL) ? a_stop : a_parser->end;
+	size_t len = end - a_parser->cursor;
+	size_t chunksCount = omp_get_max_threads();
+
+	if (chunksCount > len / SizeofChunkMin) {
+		chunksCount = len / SizeofChunkMin;
+	}
+
+	if (chunksCount < 2) {
+		return false;
+	}
+
+	nvIPFIX_import_chunk_t * chunks = calloc( chunksCount, sizeof (nvIPFIX_import_chunk_t) );
+
+	if (chunks == NULL) {
+		return false;
+	}
+
+	chunks[0].start = a_parser->cursor;
+
+	for (size_t i = 1; i < chunksCount; i++) {
+		const nvIPFIX_CHAR * start = nvipfix_import_find_boundary( a_parser, a_parser->cursor + i * (len / chunksCount), end );
+
+		if (start == NULL || start <= chunks[i - 1].start) {
+			chunksCount = i;
+			break;
+		}
+
+		chunks[i].start = start;
+	}
+
+	if (chunksCount > 1) {
+		#pragma omp parallel for schedule (static, 1)
+		for (size_t i = 0; i < chunksCount; i++) {
+			nvIPFIX_import_parser_t parser = *a_parser;
+			const nvIPFIX_CHAR * stop = (i + 1 < chunksCount) ? chunks[i + 1].start : a_stop;
+
+			/*
+			 * a guessed start inside a string parses garbage until the guess is rejected,
+			 * its warnings are only worth logging once the join proves the start right
+			 */
+			parser.cursor = chunks[i].start;
+			parser.block = NULL;
+			parser.isQuiet = i > 0;
+			parser.warningsCount = 0;
+
+			chunks[i].status = nvipfix_import_parse_records( &parser, stop, SIZE_MAX,
+					&(chunks[i].list), &(chunks[i].count) );
+			chunks[i].cursor = parser.cursor;
+			chunks[i].warningsCount = parser.warningsCount;
+		}
+
+		result = (a_stop == NULL) ? chunks[chunksCount - 1].status == NV_IPFIX_IMPORT_STATUS_END
+				: chunks[chunksCount - 1].status == NV_IPFIX_IMPORT_STATUS_RECORD
+					&& chunks[chunksCount - 1].cursor == a_stop;
+
+		for (size_t i = 0; result && i + 1 < chunksCount; i++) {
+			result = chunks[i].status == NV_IPFIX_IMPORT_STATUS_RECORD && chunks[i].cursor == chunks[i + 1].start;
+		}
+
+		for (size_t i = 0; i < chunksCount; i++) {
+			if (result && chunks[i].warningsCount > 0) {
+				nvIPFIX_import_parser_t parser = *a_parser;
+				nvIPFIX_data_record_list_t * list = NULL;
+				size_t count = 0;
+
+				/*
+				 * the held back warnings are real, parse the chunk once more to log them
+				 */
+				parser.cursor = chunks[i].start;
+				parser.block = NULL;
+				nvipfix_import_parse_records( &parser, chunks[i].cursor, SIZE_MAX, &list, &count );
+				nvipfix_data_list_free( list );
+			}
+
+			if (result) {
+				*a_list = nvipfix_data_list_concat( *a_list, chunks[i].list );
+				*a_count += chunks[i].count;
+			}
+			else {
+				nvipfix_data_list_free( chunks[i].list );
+			}
+		}
+
+		NVIPFIX_LOG_DEBUG0( "chunks count = %u, %s", (unsigned)chunksCount, result ? "joined" : "discarded" );
+	}
+
+	free( chunks );
+#endif
+
+	return result;
+}
+
+/**
+ * parse records of the "data" array into a list
+ * @param a_parser
+ * @param a_stop stop before a record starting here (NULL to parse up to the end of the array)
+ * @param a_maxCount stop after this many records
+ * @param a_list
+ * @param a_count incremented for each record added
+ * @return NV_IPFIX_IMPORT_STATUS_RECORD if stopped at a_stop or a_maxCount
+ */
+nvIPFIX_IMPORT_STATUS nvipfix_import_parse_records( nvIPFIX_import_parser_t * a_parser, const nvIPFIX_CHAR * a_stop,
+		size_t a_maxCount, nvIPFIX_data_record_list_t * * a_list, size_t * a_count )
+{
+	nvIPFIX_IMPORT_STATUS result;
+
+	for (size_t count = 0; ; count++) {
+		a_parser->cursor = (a_parser->delimiter != '\0') ? nvipfix_import_skip_newlines( a_parser->cursor, a_parser->end )
+				: nvipfix_import_skip_separators( a_parser->cursor, a_parser->end );
+		a_parser->record = a_parser->cursor;
+
+		if ((a_stop != NULL && a_parser->cursor >= a_stop) || count == a_maxCount) {
+			result = NV_IPFIX_IMPORT_STATUS_RECORD;
+			break;
+		}
+
+		nvIPFIX_data_record_t data = { 0 };
+
+		result = (a_parser->delimiter != '\0') ? nvipfix_import_parse_row( a_parser, &data )
+				: nvipfix_import_parse_record( a_parser, &data );
+
+		if (result == NV_IPFIX_IMPORT_STATUS_RECORD && a_parser->isRowRejected) {
+			a_parser->isRowRejected = false;
+		}
+		else if (result == NV_IPFIX_IMPORT_STATUS_RECORD) {
+			nvIPFIX_data_record_list_t * list = nvipfix_data_list_add_copy( *a_list, &data );
+			*a_list = (list != NULL) ? list : *a_list;
+			(*a_count)++;
+		}
+		else {
+			break;
+		}
+	}
+
+	return result;
+}
+
+/**
+ * parse next record of the "data" array
+ * @param a_parser
+ * @param a_record
+ * @return
+ */
+nvIPFIX_IMPORT_STATUS nvipfix_import_parse_record( nvIPFIX_import_parser_t * a_parser, nvIPFIX_data_record_t * a_record )
+{
+	nvIPFIX_IMPORT_STATUS result = NV_IPFIX_IMPORT_STATUS_ERROR;
+	const nvIPFIX_CHAR * s = a_parser->cursor;
+	const nvIPFIX_CHAR * end = a_parser->end;
+
+	s = nvipfix_import_skip_separators( s, end );
+
+	if (s == end || *s == ']') {
+		a_parser->cursor = s;
+
+		return NV_IPFIX_IMPORT_STATUS_END;
+	}
+
+	if (*s == '{') {
+		size_t position = 0;
+		s++;
+
+		while (s != NULL) {
+			s = nvipfix_import_skip_whitespace( s, end );
+
+			if (s == end) {
+				break;
+			}
+
+			if (*s == '}') {
+				s++;
+				result = NV_IPFIX_IMPORT_STATUS_RECORD;
+				break;
+			}
+
+			if (*s == ',') {
+				s++;
+				continue;
+			}
+
+			if (*s != '"') {
+				break;
+			}
+
+			/*
+			 * records of a capture share their shape: try the item seen at this position first,
+			 * which also predicts where the key ends
+			 */
+			nvIPFIX_string_span_t key = { .value = s + 1 };
+			const nvIPFIX_import_item_t * item = (position < SizeofShape) ? a_parser->shape[position] : NULL;
+
+			if (item != NULL && item->nameLen < (size_t)(end - key.value) && key.value[item->nameLen] == '"'
+					&& memcmp( key.value, item->name, item->nameLen ) == 0) {
+				s = key.value + item->nameLen;
+				key.len = item->nameLen;
+			}
+			else {
+				s = nvipfix_import_scan_quote( a_parser, key.value );
+
+				if (s == NULL) {
+					break;
+				}
+
+				key.len = s - key.value;
+				item = nvipfix_import_get_item( &key );
+
+				if (position < SizeofShape) {
+					a_parser->shape[position] = item;
+				}
+			}
+
+			/*
+			 * values of fields no export needs are only skipped
+			 */
+			bool isNeeded = item == NULL || (a_parser->fields & item->dataField) != 0;
+
+			position++;
+			s = nvipfix_import_skip_whitespace( s + 1, end );
+
+			if (s == end || *s != ':') {
+				break;
+			}
+
+			s = nvipfix_import_skip_whitespace( s + 1, end );
+
+			if (s == end) {
+				break;
+			}
+
+			nvIPFIX_string_span_t value = { .value = s };
+
+			if (*s == '"') {
+				value.value = s + 1;
+				s = nvipfix_import_scan_quote( a_parser, value.value );
+
+				if (s != NULL) {
+					value.len = s - value.value;
+					s++;
+
+					if (isNeeded) {
+						nvipfix_import_set_item( a_parser, a_record, item, &key, &value );
+					}
+				}
+			}
+			else if (*s == '{' || *s == '[') {
+				s = nvipfix_import_skip_nested( s, end );
+			}
+			else {
+				s = nvipfix_import_scan( a_parser, s, false );
+
+				if (s == NULL) {
+					break;
+				}
+
+				if (isNeeded) {
+					value.len = s - value.value;
+
+					while (value.len > 0 && NVIPFIX_IMPORT_IS_WHITESPACE( value.value[value.len - 1] )) {
+						value.len--;
+					}
+
+					nvipfix_import_set_item( a_parser, a_record, item, &key, &value );
+				}
+			}
+		}
+	}
+
+	if (s != NULL) {
+		a_parser->cursor = s;
+	}
+
+	return result;
+}
+
+/**
+ * parse next row of delimited input, fields beyond the header columns are ignored
+ * @param a_parser
+ * @param a_record
+ * @return NV_IPFIX_IMPORT_STATUS_ERROR if the row is not terminated and more input may follow
+ */
+nvIPFIX_IMPORT_STATUS nvipfix_import_parse_row( nvIPFIX_import_parser_t * a_parser, nvIPFIX_data_record_t * a_record )
+{
+	const nvIPFIX_CHAR * s = a_parser->cursor;
+	const nvIPFIX_CHAR * end = a_parser->end;
+
+	if (s == end) {
+		return NV_IPFIX_IMPORT_STATUS_END;
+	}
+
+	const nvIPFIX_CHAR * eol = memchr( s, '\n', end - s );
+
+	if (eol == NULL) {
+		if (!a_parser->isLast) {
+			return NV_IPFIX_IMPORT_STATUS_ERROR;
+		}
+
+		eol = end;
+	}
+
+	const nvIPFIX_CHAR * rowEnd = (eol > s && eol[-1] == '\r') ? eol - 1 : eol;
+	bool isValid = true;
+
+	for (size_t column = 0; column < a_parser->columnsCount; column++) {
+		const nvIPFIX_CHAR * next = memchr( s, a_parser->delimiter, rowEnd - s );
+		nvIPFIX_string_span_t value = { .value = s, .len = ((next != NULL) ? next : rowEnd) - s };
+		const nvIPFIX_import_item_t * item = a_parser->columns[column];
+
+		if (item != NULL && value.len > 0) {
+			isValid = nvipfix_import_set_item( a_parser, a_record, item, NULL, &value ) && isValid;
+		}
+
+		if (next == NULL) {
+			break;
+		}
+
+		s = next + 1;
+	}
+
+	/*
+	 * a row missing a field would be exported as a different flow, it is dropped instead
+	 */
+	a_parser->isRowRejected = !isValid;
+
+	if (!isValid && !a_parser->isQuiet) {
+		nvipfix_log_warning( "%s: row dropped: '%.*s'", __func__, (int)(rowEnd - a_parser->cursor), a_parser->cursor );
+	}
+
+	a_parser->cursor = (eol < end) ? eol + 1 : end;
+
+	return NV_IPFIX_IMPORT_STATUS_RECORD;
+}
+
+/**
+ * parse a value into a record field
+ * value is copied into a bounded stack buffer only to terminate it for the Items[] parsers
+ * @param a_parser
+ * @param a_record
+ * @param a_item resolved item or NULL if the key is unknown
+ * @param a_key used only if a_item is NULL
+ * @param a_value
+ * @return false if the value was not set (the warning is logged)
+ */
+bool nvipfix_import_set_item( nvIPFIX_import_parser_t * a_parser, nvIPFIX_data_record_t * a_record,
+		const nvIPFIX_import_item_t * a_item, const nvIPFIX_string_span_t * a_key, const nvIPFIX_string_span_t * a_value )
+{
+	const nvIPFIX_import_item_t * importItem = a_item;
+	bool isValid = importItem != NULL && a_value->len < SizeofValueBuffer;
+
+	if (isValid) {
+		nvIPFIX_CHAR value[SizeofValueBuffer];
+
+		memcpy( value, a_value->value, a_value->len );
+		value[a_value->len] = '\0';
+
+		isValid = importItem->parseValue( value, ((char *)a_record) + importItem->offset );
+	}
+
+	if (isValid) {
+		return true;
+	}
+
+	if (a_parser->isQuiet) {
+		a_parser->warningsCount++;
+	}
+	else if (importItem == NULL) {
+		nvipfix_log_warning( "%s: unknown item = '%.*s'", __func__, (int)a_key->len, a_key->value );
+	}
+	else if (a_value->len >= SizeofValueBuffer) {
+		nvipfix_log_warning( "%s: value too long, item = '%s'", __func__, importItem->name );
+	}
+	else {
+		nvipfix_log_warning( "%s: invalid value, item = '%s'", __func__, importItem->name );
+	}
+
+	return false;
+}
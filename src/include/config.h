@@ -37,6 +37,34 @@ typedef enum {
 	NV_IPFIX_TRANSPORT_SCTP	           //!< SCTP
 } nvIPFIX_TRANSPORT;
 
+/**
+ *
+ */
+typedef enum {
+	NV_IPFIX_NVC_EXPORT_CHUNKED = 0,	//!< records are exported a chunk at a time
+	NV_IPFIX_NVC_EXPORT_STREAMING		//!< records are exported as they are received
+} nvIPFIX_NVC_EXPORT_MODE;
+
+/**
+ * connections polled from the switch, the switch applies the filter
+ */
+typedef struct {
+	int vlan;						//!< -1 for any
+	const nvIPFIX_CHAR * vnet;		//!< NULL for any
+	int clientPort;					//!< -1 for any
+	int serverPort;					//!< -1 for any
+	int protocol;					//!< -1 for any
+} nvIPFIX_conn_filter_t;
+
+/**
+ * how the switch formats polled connections
+ */
+typedef struct {
+	const nvIPFIX_CHAR * sumBy;		//!< comma separated keys connections are summed up by, NULL for none
+	const nvIPFIX_CHAR * sortAsc;	//!< NULL for none
+	const nvIPFIX_CHAR * sortDesc;	//!< NULL for none
+} nvIPFIX_conn_format_t;
+
 /**
  *
  */
@@ -57,6 +85,7 @@ typedef struct {
 	nvIPFIX_ip_address_t ipAddress;	//!< collector's IP address
 	nvIPFIX_OCTET dscp;
 	nvIPFIX_TRANSPORT transport;	//!< collector's transport
+	const nvIPFIX_CHAR * exportFields;	//!< comma separated IEs to export, NULL for all
 	nvIPFIX_hashtable_key_t key;
 	void *ctx;
 } nvIPFIX_collector_info_t;
@@ -85,6 +114,60 @@ void nvipfix_config_switch_info_free( nvIPFIX_switch_info_t * a_switchInfo );
  */
 nvIPFIX_timespan_t nvipfix_config_get_export_interval( void );
 
+/**
+ * maximum number of connections fetched by one nvc_show_conn_stat call
+ * @return
+ */
+nvIPFIX_U32 nvipfix_config_get_nvc_chunk_size( void );
+
+/**
+ *
+ * @return
+ */
+nvIPFIX_NVC_EXPORT_MODE nvipfix_config_get_nvc_export_mode( void );
+
+/**
+ * number of sessions to the switch a large window is polled over
+ * @return
+ */
+nvIPFIX_U32 nvipfix_config_get_nvc_connections( void );
+
+/**
+ * time a daemon poll may take, in percent of the export interval, 0 - unlimited
+ * @return
+ */
+nvIPFIX_U32 nvipfix_config_get_nvc_poll_deadline( void );
+
+/**
+ *
+ * @return
+ */
+const nvIPFIX_conn_filter_t * nvipfix_config_get_conn_filter( void );
+
+/**
+ *
+ * @return
+ */
+const nvIPFIX_conn_format_t * nvipfix_config_get_conn_format( void );
+
+/**
+ * maximum number of flows whose counters are kept between polls, 0 disables the flow cache
+ * @return
+ */
+nvIPFIX_U32 nvipfix_config_get_flow_cache_size( void );
+
+/**
+ * time a flow stays in the flow cache without being polled
+ * @return
+ */
+nvIPFIX_timespan_t nvipfix_config_get_flow_cache_timeout( void );
+
+/**
+ * time after which an unchanged running flow is exported again, 0 - never
+ * @return
+ */
+nvIPFIX_timespan_t nvipfix_config_get_flow_cache_active_timeout( void );
+
 /**
  * get linked list of collectors
  * @return pointer to list
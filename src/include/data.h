@@ -51,6 +51,46 @@ typedef enum {
 	NV_IPFIX_LAYER2_NETWORK_TYPE_NVGRE = 0x02
 } nvIPFIX_LAYER2_NETWORK_TYPE;
 
+/**
+ * where a flow was in its life when it was polled, NONE if the source does not tell
+ */
+typedef enum {
+	NV_IPFIX_FLOW_TRANSITION_NONE = 0,
+	NV_IPFIX_FLOW_TRANSITION_STARTED,
+	NV_IPFIX_FLOW_TRANSITION_RUNNING,
+	NV_IPFIX_FLOW_TRANSITION_ENDED,
+	NV_IPFIX_FLOW_TRANSITION_STARTED_AND_ENDED
+} nvIPFIX_FLOW_TRANSITION;
+
+/**
+ * data record fields, used to parse only the fields an export needs
+ */
+typedef enum {
+	NV_IPFIX_DATA_FIELD_VLAN_ID = 1 << 0,
+	NV_IPFIX_DATA_FIELD_PROTOCOL = 1 << 1,
+	NV_IPFIX_DATA_FIELD_ETHERNET_TYPE = 1 << 2,
+	NV_IPFIX_DATA_FIELD_TCP_CONTROL_BITS = 1 << 3,
+	NV_IPFIX_DATA_FIELD_INGRESS_INTERFACE = 1 << 4,
+	NV_IPFIX_DATA_FIELD_EGRESS_INTERFACE = 1 << 5,
+	NV_IPFIX_DATA_FIELD_FLOW_START = 1 << 6,
+	NV_IPFIX_DATA_FIELD_FLOW_END = 1 << 7,
+	NV_IPFIX_DATA_FIELD_FLOW_DURATION = 1 << 8,
+	NV_IPFIX_DATA_FIELD_LATENCY = 1 << 9,
+	NV_IPFIX_DATA_FIELD_DSCP = 1 << 10,
+	NV_IPFIX_DATA_FIELD_INITIATOR_OCTETS = 1 << 11,
+	NV_IPFIX_DATA_FIELD_RESPONDER_OCTETS = 1 << 12,
+	NV_IPFIX_DATA_FIELD_LAYER2_SEGMENT_ID = 1 << 13,
+	NV_IPFIX_DATA_FIELD_TRANSPORT_OCTET_DELTA_COUNT = 1 << 14,
+	NV_IPFIX_DATA_FIELD_SOURCE_MAC = 1 << 15,
+	NV_IPFIX_DATA_FIELD_SOURCE_IP = 1 << 16,
+	NV_IPFIX_DATA_FIELD_SOURCE_PORT = 1 << 17,
+	NV_IPFIX_DATA_FIELD_DESTINATION_MAC = 1 << 18,
+	NV_IPFIX_DATA_FIELD_DESTINATION_IP = 1 << 19,
+	NV_IPFIX_DATA_FIELD_DESTINATION_PORT = 1 << 20,
+	NV_IPFIX_DATA_FIELD_FLOW_COUNT = 1 << 21,
+	NV_IPFIX_DATA_FIELD_ALL = (1 << 22) - 1
+} nvIPFIX_DATA_FIELD;
+
 typedef struct _nvIPFIX_data_record_t {
 	nvIPFIX_U16 vlanId;
 	nvIPFIX_PROTOCOL protocol;
@@ -67,6 +107,8 @@ typedef struct _nvIPFIX_data_record_t {
 	nvIPFIX_U64 responderOctets;
 	nvIPFIX_U64 layer2SegmentId;
 	nvIPFIX_U64 transportOctetDeltaCount;
+	nvIPFIX_U64 flowCount;			//!< connections summed up in the record, 0 if not aggregated
+	nvIPFIX_FLOW_TRANSITION transition;
 
 	nvIPFIX_mac_address_t sourceMac;
 	nvIPFIX_ip_address_t sourceIp;
@@ -102,6 +144,22 @@ nvIPFIX_data_record_list_t * nvipfix_data_list_add( nvIPFIX_data_record_list_t *
  */
 nvIPFIX_data_record_list_t * nvipfix_data_list_add_copy( nvIPFIX_data_record_list_t * a_list, nvIPFIX_data_record_t * a_record );
 
+/**
+ * move all records of a_other to the end of a_list, a_other is freed
+ * @param a_list may be NULL
+ * @param a_other may be NULL
+ * @return
+ */
+nvIPFIX_data_record_list_t * nvipfix_data_list_concat( nvIPFIX_data_record_list_t * a_list, nvIPFIX_data_record_list_t * a_other );
+
+/**
+ * unlink a record from a list, the record is not freed
+ * @param a_list
+ * @param a_record
+ * @return
+ */
+nvIPFIX_data_record_list_t * nvipfix_data_list_remove( nvIPFIX_data_record_list_t * a_list, nvIPFIX_data_record_t * a_record );
+
 /**
  *
  * @param a_list
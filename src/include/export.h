@@ -31,6 +31,7 @@
 
 #define NVIPFIX_PEN 47269
 #define	NVIPFIX_FLOW_TID	0xA000
+#define	NVIPFIX_AGGREGATED_TID	0xA400
 #define	NVIPFIX_STATS_TID	0xA800
 #define NVIPFIX_IE_LATENCY_NAME "latencyMicroseconds"
 
@@ -40,11 +41,26 @@ enum {
 };
 
 
+/**
+ * allocate the fixbuf information model, done on first export if not called
+ * @return
+ */
+bool nvipfix_export_init( void );
+
+/**
+ * data record fields a collector's export template is built from
+ * @param a_exportFields comma separated IE names, NULL for all
+ * @return nvIPFIX_DATA_FIELD flags
+ */
+nvIPFIX_U32 nvipfix_export_get_record_fields( const nvIPFIX_CHAR * a_exportFields );
+
 /**
  *
  * @param a_host
  * @param a_port
  * @param a_transport
+ * @param a_exportFields comma separated IE names to export, NULL for all
+ * @param a_sumBy keys the records are summed up by (aggregated template), NULL if not aggregated
  * @param key
  * @param a_data
  * @param a_startTs
@@ -55,10 +71,49 @@ nvIPFIX_error_t nvipfix_export(
 		const nvIPFIX_CHAR * a_host,
 		const nvIPFIX_CHAR * a_port,
 		nvIPFIX_TRANSPORT a_transport,
+		const nvIPFIX_CHAR * a_exportFields,
+		const nvIPFIX_CHAR * a_sumBy,
 		const nvIPFIX_data_record_list_t * a_data,
 		const nvIPFIX_datetime_t * a_startTs,
 		const nvIPFIX_datetime_t * a_endTs,
 		void **ptr );
 
+/**
+ * open the collector session if needed and start an export of records appended one by one
+ * @param a_host
+ * @param a_port
+ * @param a_transport
+ * @param a_exportFields comma separated IE names to export, NULL for all
+ * @param a_sumBy keys the records are summed up by (aggregated template), NULL if not aggregated
+ * @param a_startTs flow start of records without one
+ * @param a_endTs flow end of records without one
+ * @param ptr [in, out] collector context, NULL if the session could not be opened
+ * @return
+ */
+nvIPFIX_error_t nvipfix_export_begin(
+		const nvIPFIX_CHAR * a_host,
+		const nvIPFIX_CHAR * a_port,
+		nvIPFIX_TRANSPORT a_transport,
+		const nvIPFIX_CHAR * a_exportFields,
+		const nvIPFIX_CHAR * a_sumBy,
+		const nvIPFIX_datetime_t * a_startTs,
+		const nvIPFIX_datetime_t * a_endTs,
+		void **ptr );
+
+/**
+ * append a record to the collector's buffer, full messages are sent right away
+ * @param a_ctx collector context
+ * @param a_record
+ * @return
+ */
+bool nvipfix_export_append( void * a_ctx, const nvIPFIX_data_record_t * a_record );
+
+/**
+ * send the pending records and the exporter statistics
+ * @param a_ctx collector context
+ * @return
+ */
+nvIPFIX_error_t nvipfix_export_end( void * a_ctx );
+
 
 #endif /* __NVIPFIX_EXPORT_H */
@@ -0,0 +1,87 @@
+/**
+ * This file is part of nvIPFIX
+ * Copyright (C) 2015 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * nvIPFIX is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ */
+
+#ifndef __NVIPFIX_FLOWCACHE_H
+#define __NVIPFIX_FLOWCACHE_H
+
+
+#include <time.h>
+
+#include "types.h"
+#include "data.h"
+
+
+/**
+ * byte counters of the flows seen in previous polls, keyed by
+ * addresses, ports, protocol, VLAN and VXLAN
+ */
+typedef struct _nvIPFIX_flowcache_t nvIPFIX_flowcache_t;
+
+
+/**
+ *
+ * @param a_capacity maximum number of flows, flows beyond it are exported with their counters as is
+ * @param a_idleTimeout seconds a flow is kept without being seen
+ * @param a_activeTimeout seconds after which a running flow is exported even if unchanged, 0 - never
+ * @return
+ */
+nvIPFIX_flowcache_t * nvipfix_flowcache_create( size_t a_capacity, unsigned a_idleTimeout, unsigned a_activeTimeout );
+
+/**
+ *
+ * @param a_cache
+ */
+void nvipfix_flowcache_free( nvIPFIX_flowcache_t * a_cache );
+
+/**
+ * replace the record's byte counters with their increase since the flow was last seen
+ * @param a_cache
+ * @param a_record [in, out]
+ * @param a_now
+ * @return false if the flow need not be exported: it was seen before, its counters did not change,
+ * its end was already exported and the active timeout did not pass since its last export
+ */
+bool nvipfix_flowcache_update( nvIPFIX_flowcache_t * a_cache, nvIPFIX_data_record_t * a_record, time_t a_now );
+
+/**
+ * nvipfix_flowcache_update() every record of a list, unchanged flows are removed from it
+ * @param a_cache
+ * @param a_list [in, out]
+ * @param a_now
+ */
+void nvipfix_flowcache_update_list( nvIPFIX_flowcache_t * a_cache, nvIPFIX_data_record_list_t * a_list, time_t a_now );
+
+/**
+ * drop the flows idle for longer than the timeout
+ * @param a_cache
+ * @param a_now
+ * @return number of flows dropped
+ */
+size_t nvipfix_flowcache_expire( nvIPFIX_flowcache_t * a_cache, time_t a_now );
+
+/**
+ *
+ * @param a_cache
+ * @return number of flows
+ */
+size_t nvipfix_flowcache_get_count( const nvIPFIX_flowcache_t * a_cache );
+
+
+#endif /* __NVIPFIX_FLOWCACHE_H */
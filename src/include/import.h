@@ -26,8 +26,15 @@
 
 #include "types.h"
 #include "data.h"
+#include "config.h"
 
 
+/**
+ * build the Items[] index, select the structural scanner and initialize OpenSSL (NVC builds),
+ * done on first import if not called
+ */
+void nvipfix_import_init( void );
+
 /**
  * import datafile
  * @param a_file
@@ -35,6 +42,14 @@
  */
 nvIPFIX_data_record_list_t * nvipfix_import( FILE * a_file );
 
+/**
+ * import data from a memory buffer (buffer is not modified and needs no terminator)
+ * @param a_buffer
+ * @param a_len buffer length
+ * @return
+ */
+nvIPFIX_data_record_list_t * nvipfix_import_buffer( const nvIPFIX_CHAR * a_buffer, size_t a_len );
+
 /**
  * import datafile
  * @param a_fileName filename
@@ -42,15 +57,112 @@ nvIPFIX_data_record_list_t * nvipfix_import( FILE * a_file );
  */
 nvIPFIX_data_record_list_t * nvipfix_import_file( const nvIPFIX_CHAR * a_fileName );
 
-#ifdef NVIPFIX_DEF_ENABLE_NVC
+/**
+ * parse only the given data record fields, values of other fields are skipped (all fields by default)
+ * @param a_fields nvIPFIX_DATA_FIELD flags
+ */
+void nvipfix_import_set_record_fields( nvIPFIX_U32 a_fields );
+
+/**
+ * get the start time of the first record of a datafile, only the beginning of the file is read
+ * @param a_fileName
+ * @param a_start [out]
+ * @return false if there is no record or the first one has no start time
+ */
+bool nvipfix_import_file_get_start( const nvIPFIX_CHAR * a_fileName, nvIPFIX_datetime_t * a_start );
+
+/**
+ * incremental import of a datafile with a fixed-size read window
+ */
+typedef struct _nvIPFIX_import_stream_t nvIPFIX_import_stream_t;
+
+/**
+ * open a datafile for incremental import
+ * @param a_fileName filename, "-" for stdin
+ * @return NULL on error
+ */
+nvIPFIX_import_stream_t * nvipfix_import_stream_open( const nvIPFIX_CHAR * a_fileName );
+
+/**
+ * import the next batch of records
+ * @param a_stream
+ * @param a_maxRecords batch size (a batch may exceed it slightly once records are parsed in chunks)
+ * @return NULL when there are no more records
+ */
+nvIPFIX_data_record_list_t * nvipfix_import_stream_read( nvIPFIX_import_stream_t * a_stream, size_t a_maxRecords );
 
 /**
  *
- * @return
+ * @param a_stream
  */
-nvIPFIX_data_record_list_t * nvipfix_import_nvc( const nvIPFIX_CHAR * a_host, 
+void nvipfix_import_stream_close( nvIPFIX_import_stream_t * a_stream );
+
+#ifdef NVIPFIX_DEF_ENABLE_NVC
+
+/**
+ * receives the records of one chunk, the list is freed when the function returns
+ */
+typedef void (* nvIPFIX_import_nvc_chunk_func_t)( nvIPFIX_data_record_list_t * a_dataRecords, void * a_arg );
+
+/**
+ * receives one record as soon as the switch sends it
+ */
+typedef void (* nvIPFIX_import_nvc_record_func_t)( const nvIPFIX_data_record_t * a_record, void * a_arg );
+
+/**
+ * where the records of a poll go
+ */
+typedef struct {
+	nvIPFIX_import_nvc_chunk_func_t chunkFunc;		//!< records in chunks, complete sub-windows only
+	nvIPFIX_import_nvc_record_func_t recordFunc;	//!< if set, each record instead, nothing is buffered
+	void * arg;
+} nvIPFIX_import_nvc_sink_t;
+
+/**
+ * poll connection statistics of the window [a_start, a_end) in chunks of bounded size,
+ * each connection active in the window is handed over once
+ * @param a_host
+ * @param a_login
+ * @param a_password
+ * @param a_start
+ * @param a_end
+ * @param a_chunkSize maximum number of connections per nvc_show_conn_stat call
+ * @param a_sessionsCount sessions a window too large for a chunk is polled over concurrently
+ * @param a_deadline time the poll is cancelled at, the sub-windows complete by then are handed over
+ * 	(streamed records as they arrive) and the rest is left to the next poll; 0 - none
+ * @param a_filter connections to poll, NULL for all
+ * @param a_format aggregation and order of the connections, NULL for none
+ * @param a_sink receives the records in time order
+ * @param a_fetchedEnd [out] end of the sub-windows handed over in full, from a_start on (a_end after a complete poll);
+ * 	a streamed sub-window cut off after some of its records is counted in, the rest of it is lost
+ * @return false if the switch could not be polled (records before the failure are handed over)
+ */
+bool nvipfix_import_nvc( const nvIPFIX_CHAR * a_host,
     const nvIPFIX_CHAR * a_login, const nvIPFIX_CHAR * a_password,
-	const nvIPFIX_datetime_t * a_startTs, const nvIPFIX_datetime_t * a_endTs, int within_last );
+	time_t a_start, time_t a_end,
+	nvIPFIX_U32 a_chunkSize, unsigned a_sessionsCount, time_t a_deadline,
+	const nvIPFIX_conn_filter_t * a_filter, const nvIPFIX_conn_format_t * a_format,
+	const nvIPFIX_import_nvc_sink_t * a_sink, time_t * a_fetchedEnd );
+
+/**
+ * whether a window the switch cut at the chunk size is polled again in halves: not if it is a second long,
+ * the connections running through all of it fill a chunk by themselves (every half would return them again)
+ * or the connections are summed up (the sums of both halves would hold a connection running through them)
+ * @param a_length seconds
+ * @param a_rowsCount rows the switch returned for the window
+ * @param a_spanningCount connections among them running through the whole window
+ * @param a_chunkSize
+ * @param a_format NULL for none
+ * @return
+ */
+bool nvipfix_import_nvc_is_split_useful( time_t a_length, size_t a_rowsCount, size_t a_spanningCount,
+		nvIPFIX_U32 a_chunkSize, const nvIPFIX_conn_format_t * a_format );
+
+/**
+ *
+ * @return time the switch may be connected to again after failed attempts, 0 if it may be at once
+ */
+time_t nvipfix_import_nvc_get_retry_time( void );
 
 #endif
 
@@ -46,6 +46,11 @@
 	nvipfix_tlog_error( NVIPFIX_T( a_fmt ), __VA_ARGS__ ); }
 
 
+/**
+ * load log4c configuration, done on first use if not called
+ */
+void nvipfix_log_init( void );
+
 /**
  *
  * @param a_path
@@ -26,13 +26,21 @@
 #include "data.h"
 
 
+/**
+ * initialize logging, configuration, OpenSSL and the fixbuf information model once per process,
+ * so that no export interval pays for it
+ * @return false if the information model cannot be allocated
+ */
+bool nvipfix_main_init( void );
+
 /**
  *
  * @param a_dataRecords
+ * @param a_sumBy keys the records are summed up by, NULL if not aggregated
  * @param a_startTs
  * @param a_endTs
  */
-void nvipfix_main_export( nvIPFIX_data_record_list_t * a_dataRecords,
+void nvipfix_main_export( nvIPFIX_data_record_list_t * a_dataRecords, const nvIPFIX_CHAR * a_sumBy,
 		const nvIPFIX_datetime_t * a_startTs, const nvIPFIX_datetime_t * a_endTs );
 
 /**
@@ -45,11 +53,31 @@ void nvipfix_main_export_file( const nvIPFIX_CHAR * a_filename,
 		const nvIPFIX_datetime_t * a_startTs, const nvIPFIX_datetime_t * a_endTs );
 
 /**
- *
+ * export several datafiles through the same collector sessions, ordered by the start of their first record
+ * files are parsed in parallel
+ * @param a_fileNames filenames or glob patterns
+ * @param a_count
  * @param a_startTs
  * @param a_endTs
  */
-void nvipfix_main_export_nvc( const nvIPFIX_datetime_t * a_startTs, const nvIPFIX_datetime_t * a_endTs, int within_last );
+void nvipfix_main_export_files( const nvIPFIX_CHAR * const * a_fileNames, size_t a_count,
+		const nvIPFIX_datetime_t * a_startTs, const nvIPFIX_datetime_t * a_endTs );
+
+/**
+ * poll the switch for the connections of [a_start, a_end) and export them
+ * @param a_start
+ * @param a_end
+ * @param a_deadline time the poll is cut short at, 0 - none
+ * @param a_fetchedEnd [out] the window is exported in full up to here, the rest is to be polled again; may be NULL
+ * @return false if the window could not be fetched in full
+ */
+bool nvipfix_main_export_nvc( time_t a_start, time_t a_end, time_t a_deadline, time_t * a_fetchedEnd );
+
+/**
+ *
+ * @return time the switch may be polled again after failed connection attempts, 0 if it may be at once
+ */
+time_t nvipfix_main_get_nvc_retry_time( void );
 
 
 #endif /* __NVIPFIX_MAIN_H */
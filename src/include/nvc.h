@@ -46,7 +46,16 @@
 #define nvc_stats_args_end_time ((uint64_t)1 << 2)
 #define nvc_stats_args_within_last ((uint64_t)1 << 7)
 
+#define nvc_conn_vnet ((uint64_t)1 << 9)
+#define nvc_conn_vlan ((uint64_t)1 << 10)
+#define nvc_conn_client_port ((uint64_t)1 << 21)
+#define nvc_conn_server_port ((uint64_t)1 << 22)
+#define nvc_conn_proto ((uint64_t)1 << 24)
+
+#define	nvc_format_args_sort_asc	((uint64_t)1 << 0)
+#define	nvc_format_args_sort_desc	((uint64_t)1 << 1)
 #define	nvc_format_args_limit_output	((uint64_t)1 << 2)
+#define	nvc_format_args_sum_by	((uint64_t)1 << 3)
 
 
 #ifndef __SVR4
@@ -146,6 +146,12 @@ typedef enum {
 	NV_IPFIX_ADDRESS_OCTETS_COUNT_MAC = 6
 } nvIPFIX_ADDRESS_OCTETS_COUNT;
 
+typedef enum {
+	NV_IPFIX_PARSE_STATUS_OK = 0,
+	NV_IPFIX_PARSE_STATUS_INVALID,
+	NV_IPFIX_PARSE_STATUS_OVERFLOW
+} nvIPFIX_PARSE_STATUS;
+
 typedef struct {
 	nvIPFIX_U32 value;
 
@@ -290,6 +296,25 @@ nvIPFIX_CHAR * nvipfix_string_trim( nvIPFIX_CHAR * a_s, const nvIPFIX_CHAR * a_t
  */
 nvIPFIX_CHAR * nvipfix_string_trim_copy( const nvIPFIX_CHAR * a_s, const nvIPFIX_CHAR * a_trimChars );
 
+/**
+ * convert decimal digits to an unsigned 64-bit integer, 8 digits per step
+ * (no sign, no whitespace, no terminator needed; a_value is set only on success)
+ * @param a_s
+ * @param a_len number of characters
+ * @param a_value
+ * @return
+ */
+nvIPFIX_PARSE_STATUS nvipfix_parse_decimal_u64( const nvIPFIX_CHAR * a_s, size_t a_len, nvIPFIX_U64 * a_value );
+
+/**
+ * convert optionally signed decimal digits to a signed 64-bit integer
+ * @param a_s
+ * @param a_len number of characters
+ * @param a_value
+ * @return
+ */
+nvIPFIX_PARSE_STATUS nvipfix_parse_decimal_i64( const nvIPFIX_CHAR * a_s, size_t a_len, nvIPFIX_I64 * a_value );
+
 /**
  * duplicate a string
  * @param a_s
@@ -362,6 +387,24 @@ bool nvipfix_parse_i64( const char * a_s, void * a_value );
  */
 bool nvipfix_parse_u64( const char * a_s, void * a_value );
 
+/**
+ * convert dotted decimal to an IPv4 address without allocating, octets are range checked
+ * @param a_s
+ * @param a_len number of characters
+ * @param a_address set only on success (hasValue is always updated)
+ * @return
+ */
+bool nvipfix_ip_address_parse( const nvIPFIX_CHAR * a_s, size_t a_len, nvIPFIX_ip_address_t * a_address );
+
+/**
+ * convert hh:hh:hh:hh:hh:hh to a MAC address without allocating
+ * @param a_s
+ * @param a_len number of characters
+ * @param a_address set only on success (hasValue is always updated)
+ * @return
+ */
+bool nvipfix_mac_address_parse( const nvIPFIX_CHAR * a_s, size_t a_len, nvIPFIX_mac_address_t * a_address );
+
 /**
  * convert string to an IP address (nvIPFIX_ip_address_t)
  * @param a_s
@@ -378,6 +421,18 @@ bool nvipfix_parse_ip_address( const char * a_s, void * a_value );
  */
 bool nvipfix_parse_mac_address( const char * a_s, void * a_value );
 
+/**
+ * convert YYYY-MM-DDTHH:MM:SS[.fff][Z|+hh[:mm]|-hh[:mm]] to a datetime without allocating
+ * (the zone is kept in tzOffset, fields + tzOffset = UTC)
+ * @param a_s
+ * @param a_len number of characters
+ * @param a_datetime
+ * @param a_microseconds microseconds since 1970-01-01T00:00:00Z (optional)
+ * @return
+ */
+bool nvipfix_datetime_parse_iso8601( const nvIPFIX_CHAR * a_s, size_t a_len, nvIPFIX_datetime_t * a_datetime,
+		nvIPFIX_I64 * a_microseconds );
+
 /**
  * convert ISO 8601 string to a datetime (nvIPFIX_datetime_t)
  * @param a_s
@@ -427,6 +482,13 @@ const nvIPFIX_CHAR * nvipfix_ip_address_to_string( const nvIPFIX_ip_address_t *
 nvIPFIX_U32 nvipfix_datetime_get_seconds_since_epoch( const nvIPFIX_datetime_t * a_datetime,
 		int a_epoch_year, int a_epoch_month );
 
+/**
+ * microseconds since 1970-01-01T00:00:00Z, computed from the fields and tzOffset
+ * @param a_datetime
+ * @return
+ */
+nvIPFIX_I64 nvipfix_datetime_get_microseconds_since_epoch( const nvIPFIX_datetime_t * a_datetime );
+
 /**
  *
  * @param a_datetime
@@ -435,7 +497,7 @@ nvIPFIX_U32 nvipfix_datetime_get_seconds_since_epoch( const nvIPFIX_datetime_t *
 time_t nvipfix_datetime_add_timespan( nvIPFIX_datetime_t * a_datetime, const nvIPFIX_timespan_t * a_timespan );
 
 /**
- *
+ * seconds since the epoch, computed from the fields and tzOffset (the local zone is not involved)
  * @param a_datetime
  * @return
  */
@@ -48,7 +48,6 @@ extern int log4cfg_size;
 	va_end( args )
 
 
-static void nvipfix_log_init( void );
 static void nvipfix_log_cleanup( void );
 static void nvipfix_log( int a_priority, const char * a_fmt, va_list * args );
 static void nvipfix_tlog( int a_priority, const nvIPFIX_TCHAR * a_fmt, va_list * args );
@@ -123,6 +122,10 @@ void nvipfix_log_init( void )
 {
 	static volatile bool isInitialized = false;
 
+	if (isInitialized) {
+		return;
+	}
+
 	#pragma omp critical (nvipfixCritical_LogInit)
 	{
 		if (!isInitialized) {
@@ -18,16 +18,89 @@
  *
  */
 
+#include <string.h>
+
 #include "include/log.h"
 #include "include/data.h"
 #include "include/config.h"
 #include "include/import.h"
 #include "include/export.h"
+#include "include/flowcache.h"
 
 #include "include/main.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef NVIPFIX_DEF_POSIX
+#include <glob.h>
+#endif
+
+
+enum {
+	SizeofExportBatch = 64 * 1024
+};
+
+
+typedef struct {
+	const nvIPFIX_datetime_t * startTs;
+	const nvIPFIX_datetime_t * endTs;
+	nvIPFIX_collector_info_list_item_t * collectors;
+	const nvIPFIX_CHAR * sumBy;
+	nvIPFIX_flowcache_t * flowCache;	//!< NULL if the records are exported with their totals
+	time_t now;
+	size_t chunksCount;
+	size_t recordsCount;			//!< records streamed
+} nvIPFIX_main_nvc_export_t;
+
+typedef struct {
+	const nvIPFIX_CHAR * fileName;
+	time_t start;					//!< start time of the first record, 0 if unknown
+	size_t index;					//!< position on the command line, orders files with the same start
+} nvIPFIX_main_file_t;
+
+
+static void nvipfix_main_set_record_fields( void );
+static void nvipfix_main_export_stream( nvIPFIX_import_stream_t *, nvIPFIX_data_record_list_t *,
+		const nvIPFIX_datetime_t *, const nvIPFIX_datetime_t * );
+static int nvipfix_main_compare_files( const void *, const void * );
+static void nvipfix_main_export_nvc_chunk( nvIPFIX_data_record_list_t *, void * );
+static void nvipfix_main_export_nvc_record( const nvIPFIX_data_record_t *, void * );
+static void nvipfix_main_cleanup( void );
+
+
+static nvIPFIX_flowcache_t * FlowCache = NULL;
+
+
+bool nvipfix_main_init( void )
+{
+	nvipfix_log_init();
+
+	nvipfix_config_collectors_get( );
 
-void nvipfix_main_export( nvIPFIX_data_record_list_t * a_dataRecords,
+	nvipfix_import_init();
+
+	nvIPFIX_U32 flowCacheSize = nvipfix_config_get_flow_cache_size();
+
+	if (flowCacheSize > 0 && FlowCache == NULL) {
+		nvIPFIX_timespan_t timeout = nvipfix_config_get_flow_cache_timeout();
+		nvIPFIX_timespan_t activeTimeout = nvipfix_config_get_flow_cache_active_timeout();
+
+		FlowCache = nvipfix_flowcache_create( flowCacheSize, (unsigned)nvipfix_timespan_get_seconds( &timeout ),
+				(unsigned)nvipfix_timespan_get_seconds( &activeTimeout ) );
+
+		if (FlowCache == NULL) {
+			return false;
+		}
+
+		atexit( nvipfix_main_cleanup );
+	}
+
+	return nvipfix_export_init();
+}
+
+void nvipfix_main_export( nvIPFIX_data_record_list_t * a_dataRecords, const nvIPFIX_CHAR * a_sumBy,
 		const nvIPFIX_datetime_t * a_startTs, const nvIPFIX_datetime_t * a_endTs )
 {
 	nvIPFIX_collector_info_list_item_t * collectors = nvipfix_config_collectors_get( );
@@ -47,7 +120,7 @@ void nvipfix_main_export( nvIPFIX_data_record_list_t * a_dataRecords,
 				collector->name, collector->host,
 				NVIPFIX_ARGSF_IP_ADDRESS( collector->ipAddress ), collector->port );
 
-		nvipfix_export( collector->host, collector->port, collector->transport,
+		nvipfix_export( collector->host, collector->port, collector->transport, collector->exportFields, a_sumBy,
 				a_dataRecords, a_startTs, a_endTs, &collector->ctx );
 		collectors = collectors->next;
 	}
@@ -56,31 +129,318 @@ void nvipfix_main_export( nvIPFIX_data_record_list_t * a_dataRecords,
 void nvipfix_main_export_file( const nvIPFIX_CHAR * a_filename, 
 	const nvIPFIX_datetime_t *a_startTs, const nvIPFIX_datetime_t *a_endTs)
 {
-	nvIPFIX_data_record_list_t * dataRecords = nvipfix_import_file( a_filename );
-	nvipfix_main_export( dataRecords, a_startTs, a_endTs );
+	nvipfix_main_set_record_fields();
+
+	nvIPFIX_import_stream_t * stream = nvipfix_import_stream_open( a_filename );
+
+	if (stream == NULL) {
+		return;
+	}
+
+	nvipfix_main_export_stream( stream, nvipfix_import_stream_read( stream, SizeofExportBatch ), a_startTs, a_endTs );
+}
+
+/**
+ * export a stream batch by batch, the next batch is parsed while one is exported
+ * @param a_stream closed when done
+ * @param a_dataRecords first batch (NULL if the stream has no records)
+ * @param a_startTs
+ * @param a_endTs
+ */
+void nvipfix_main_export_stream( nvIPFIX_import_stream_t * a_stream, nvIPFIX_data_record_list_t * a_dataRecords,
+		const nvIPFIX_datetime_t * a_startTs, const nvIPFIX_datetime_t * a_endTs )
+{
+	nvIPFIX_data_record_list_t * dataRecords = a_dataRecords;
+
+	if (dataRecords == NULL) {
+		nvipfix_main_export( NULL, NULL, a_startTs, a_endTs );
+	}
+
+#ifdef _OPENMP
+	/*
+	 * keep chunk parsing parallel inside the import section
+	 */
+	omp_set_max_active_levels( 2 );
+#endif
+
+	while (dataRecords != NULL) {
+		nvIPFIX_data_record_list_t * nextRecords = NULL;
+
+		/*
+		 * export a batch while the next one is parsed
+		 */
+		#pragma omp parallel sections num_threads (2)
+		{
+			#pragma omp section
+			nextRecords = nvipfix_import_stream_read( a_stream, SizeofExportBatch );
+
+			#pragma omp section
+			nvipfix_main_export( dataRecords, NULL, a_startTs, a_endTs );
+		}
+
+		nvipfix_data_list_free( dataRecords );
+		dataRecords = nextRecords;
+	}
+
+	nvipfix_import_stream_close( a_stream );
+}
+
+void nvipfix_main_export_files( const nvIPFIX_CHAR * const * a_fileNames, size_t a_count,
+		const nvIPFIX_datetime_t * a_startTs, const nvIPFIX_datetime_t * a_endTs )
+{
+#ifdef NVIPFIX_DEF_POSIX
+	glob_t globResult = { 0 };
+
+	/*
+	 * GLOB_NOCHECK keeps names that match nothing, the import reports them
+	 */
+	for (size_t i = 0; i < a_count; i++) {
+		glob( a_fileNames[i], GLOB_NOCHECK | (i > 0 ? GLOB_APPEND : 0), NULL, &globResult );
+	}
+
+	const nvIPFIX_CHAR * const * fileNames = (const nvIPFIX_CHAR * const *)globResult.gl_pathv;
+	size_t count = globResult.gl_pathc;
+#else
+	const nvIPFIX_CHAR * const * fileNames = a_fileNames;
+	size_t count = a_count;
+#endif
+
+	bool hasStdin = false;
+
+	for (size_t i = 0; count > 1 && i < count; i++) {
+		hasStdin = hasStdin || strcmp( fileNames[i], "-" ) == 0;
+	}
+
+	nvIPFIX_main_file_t * files = (count > 1 && !hasStdin) ? calloc( count, sizeof (nvIPFIX_main_file_t) ) : NULL;
+
+	if (count == 1) {
+		nvipfix_main_export_file( fileNames[0], a_startTs, a_endTs );
+	}
+	else if (hasStdin) {
+		/*
+		 * ordering the inputs reads the head of each, stdin cannot be read twice
+		 */
+		nvipfix_log_error( "'-' (stdin) cannot be combined with other input files" );
+	}
+	else if (files == NULL) {
+		nvipfix_log_error( "%s: memory allocation failed", __func__ );
+	}
+	else {
+		/*
+		 * order the files by the start of their first record, only the head of each file is read
+		 */
+		#pragma omp parallel for schedule (dynamic)
+		for (size_t i = 0; i < count; i++) {
+			nvIPFIX_datetime_t start = { 0 };
+
+			files[i].fileName = fileNames[i];
+			files[i].index = i;
+			files[i].start = nvipfix_import_file_get_start( fileNames[i], &start ) ? nvipfix_datetime_to_ctime( &start ) : 0;
+		}
+
+		qsort( files, count, sizeof (nvIPFIX_main_file_t), nvipfix_main_compare_files );
+
+		nvipfix_main_set_record_fields();
+
+		/*
+		 * the first batch of each file is parsed on all threads, each thread waits with it until the files
+		 * before it are exported and then streams the rest of its file: the collector sessions see the records
+		 * in order and no more than a batch per thread is held ahead
+		 */
+		#pragma omp parallel for ordered schedule (dynamic, 1)
+		for (size_t i = 0; i < count; i++) {
+			nvIPFIX_import_stream_t * stream = nvipfix_import_stream_open( files[i].fileName );
+			nvIPFIX_data_record_list_t * dataRecords = (stream != NULL)
+					? nvipfix_import_stream_read( stream, SizeofExportBatch ) : NULL;
 
-	nvipfix_data_list_free( dataRecords );
+			#pragma omp ordered
+			if (stream != NULL) {
+				NVIPFIX_LOG_DEBUG( "exporting '%s'", files[i].fileName );
+				nvipfix_main_export_stream( stream, dataRecords, a_startTs, a_endTs );
+			}
+		}
+	}
+
+	free( files );
+
+#ifdef NVIPFIX_DEF_POSIX
+	globfree( &globResult );
+#endif
 }
 
-void nvipfix_main_export_nvc(const nvIPFIX_datetime_t *a_startTs, 
-    const nvIPFIX_datetime_t *a_endTs, int within_last)
+bool nvipfix_main_export_nvc( time_t a_start, time_t a_end, time_t a_deadline, time_t * a_fetchedEnd )
 {
+	nvIPFIX_datetime_t startTs = { 0 };
+	nvIPFIX_datetime_t endTs = { 0 };
+
+	if (a_fetchedEnd != NULL) {
+		*a_fetchedEnd = a_start;
+	}
+
+	if (!nvipfix_ctime_to_datetime( &startTs, &a_start ) || !nvipfix_ctime_to_datetime( &endTs, &a_end )) {
+		return false;
+	}
+
 	nvIPFIX_switch_info_t * switchInfo = nvipfix_config_switch_info_get();
 	nvipfix_log_debug( "switch: host = %s, login = %s, password = %s",
 			switchInfo->host,
 			switchInfo->login,
 			switchInfo->password );
 
-	nvIPFIX_data_record_list_t * dataRecords = NULL;
+	nvIPFIX_main_nvc_export_t export = {
+			.startTs = &startTs,
+			.endTs = &endTs,
+			.collectors = nvipfix_config_collectors_get( ),
+			.sumBy = nvipfix_config_get_conn_format()->sumBy,
+			.now = time( NULL )
+	};
+
+	/*
+	 * summed up rows have no flow key
+	 */
+	export.flowCache = (export.sumBy == NULL) ? FlowCache : NULL;
+
+	bool isStreaming = nvipfix_config_get_nvc_export_mode() == NV_IPFIX_NVC_EXPORT_STREAMING
+			&& export.collectors != NULL;
+
+	nvipfix_main_set_record_fields();
+
+	if (isStreaming) {
+		for (nvIPFIX_collector_info_list_item_t * item = export.collectors; item != NULL; item = item->next) {
+			nvIPFIX_collector_info_t * collector = item->current;
+
+			nvipfix_export_begin( collector->host, collector->port, collector->transport, collector->exportFields,
+					export.sumBy, &startTs, &endTs, &collector->ctx );
+		}
+	}
+
+	bool isOk = true;
+	time_t fetchedEnd = a_end;
 
 #ifdef NVIPFIX_DEF_ENABLE_NVC
-	dataRecords = nvipfix_import_nvc(
+	nvIPFIX_import_nvc_sink_t sink = {
+			.chunkFunc = nvipfix_main_export_nvc_chunk,
+			.recordFunc = isStreaming ? nvipfix_main_export_nvc_record : NULL,
+			.arg = &export
+	};
+
+	isOk = nvipfix_import_nvc(
 			switchInfo->host, switchInfo->login, switchInfo->password,
-			a_startTs, a_endTs, within_last);
+			a_start, a_end,
+			nvipfix_config_get_nvc_chunk_size(), nvipfix_config_get_nvc_connections(), a_deadline,
+			nvipfix_config_get_conn_filter(), nvipfix_config_get_conn_format(),
+			&sink, &fetchedEnd );
 #endif
 
-	nvipfix_main_export( dataRecords, a_startTs, a_endTs );
+	if (isStreaming) {
+		if (export.recordsCount == 0) {
+			nvipfix_log_warning( "no data records to export" );
+		}
+
+		for (nvIPFIX_collector_info_list_item_t * item = export.collectors; item != NULL; item = item->next) {
+			nvipfix_export_end( item->current->ctx );
+		}
+	}
+	else if (export.chunksCount == 0) {
+		nvipfix_main_export( NULL, export.sumBy, &startTs, &endTs );
+	}
+
+	nvipfix_flowcache_expire( export.flowCache, export.now );
 
-	nvipfix_data_list_free( dataRecords );
 	nvipfix_config_switch_info_free( switchInfo );
+
+	if (a_fetchedEnd != NULL) {
+		*a_fetchedEnd = fetchedEnd;
+	}
+
+	return isOk && fetchedEnd == a_end;
+}
+
+time_t nvipfix_main_get_nvc_retry_time( void )
+{
+#ifdef NVIPFIX_DEF_ENABLE_NVC
+	return nvipfix_import_nvc_get_retry_time();
+#else
+	return 0;
+#endif
+}
+
+/**
+ * export a chunk of a switch poll before the next one is fetched
+ * @param a_dataRecords
+ * @param a_arg nvIPFIX_main_nvc_export_t
+ */
+void nvipfix_main_export_nvc_chunk( nvIPFIX_data_record_list_t * a_dataRecords, void * a_arg )
+{
+	nvIPFIX_main_nvc_export_t * export = a_arg;
+
+	export->chunksCount++;
+
+	if (export->flowCache != NULL) {
+		nvipfix_flowcache_update_list( export->flowCache, a_dataRecords, export->now );
+
+		if (a_dataRecords->head == NULL) {
+			return;
+		}
+	}
+
+	nvipfix_main_export( a_dataRecords, export->sumBy, export->startTs, export->endTs );
+}
+
+/**
+ * append a record of a switch poll to the collectors' buffers while the switch sends the next ones
+ * @param a_record
+ * @param a_arg nvIPFIX_main_nvc_export_t
+ */
+void nvipfix_main_export_nvc_record( const nvIPFIX_data_record_t * a_record, void * a_arg )
+{
+	nvIPFIX_main_nvc_export_t * export = a_arg;
+	nvIPFIX_data_record_t record;
+
+	if (export->flowCache != NULL) {
+		record = *a_record;
+
+		if (!nvipfix_flowcache_update( export->flowCache, &record, export->now )) {
+			return;
+		}
+
+		a_record = &record;
+	}
+
+	for (nvIPFIX_collector_info_list_item_t * item = export->collectors; item != NULL; item = item->next) {
+		nvipfix_export_append( item->current->ctx, a_record );
+	}
+
+	export->recordsCount++;
+}
+
+void nvipfix_main_cleanup( void )
+{
+	nvipfix_flowcache_free( FlowCache );
+	FlowCache = NULL;
+}
+
+/**
+ * import only the fields the collectors' export templates need
+ */
+void nvipfix_main_set_record_fields( void )
+{
+	nvIPFIX_collector_info_list_item_t * collectors = nvipfix_config_collectors_get( );
+	nvIPFIX_U32 fields = 0;
+
+	while (collectors != NULL) {
+		fields |= nvipfix_export_get_record_fields( collectors->current->exportFields );
+		collectors = collectors->next;
+	}
+
+	nvipfix_import_set_record_fields( fields );
+}
+
+int nvipfix_main_compare_files( const void * a_file1, const void * a_file2 )
+{
+	const nvIPFIX_main_file_t * file1 = a_file1;
+	const nvIPFIX_main_file_t * file2 = a_file2;
+
+	return (file1->start != file2->start) ? ((file1->start < file2->start) ? -1 : 1)
+			: ((file1->index < file2->index) ? -1 : (file1->index > file2->index) ? 1 : 0);
 }
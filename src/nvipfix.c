@@ -77,9 +77,11 @@ void Usage()
 	puts( "Usage: nvIPFIX start|stop" );
     puts( "\tstart - start nvIPFIX daemon" );
     puts( "\tstop - stop nvIPFIX daemon" );
-    puts( "Usage: nvIPFIX [-fdatafile] <start_ts> <end_ts>" );
-	puts( "\tdatafile - data file in JSON format (for debug purpose)" );
-	puts( "\tstart_ts/end_ts - ISO 8601 datetime (YYYY-MM-DDTHH:mm:SS)" );
+    puts( "Usage: nvIPFIX [-fdatafile ...] <start_ts> <end_ts>" );
+	puts( "\tdatafile - data file in JSON format or delimited CLI output with a header line (for debug purpose), "
+			"- for stdin, may be gzip or zstd compressed" );
+	puts( "\t\tseveral -f options or a quoted glob pattern export the files in the order of their first record" );
+	puts( "\tstart_ts/end_ts - ISO 8601 datetime (YYYY-MM-DDTHH:mm:SS[.fff][Z|+hh:mm|-hh:mm])" );
 }
 
 int main( int argc, char * argv[] )
@@ -97,7 +99,11 @@ int main( int argc, char * argv[] )
 	appPath = (char *) malloc(FILENAME_MAX);
 
 	if (strncmp( "-f", argv[1], 2 ) == 0) {
-		argIndexTs = 2;
+		while (argIndexTs < (size_t)argc && strncmp( "-f", argv[argIndexTs], 2 ) == 0) {
+			argv[argIndexTs] += 2;
+			argIndexTs++;
+		}
+
 		useFile = true;
 	}
 	else if (strcmp( "start", argv[1] ) == 0) {
@@ -149,20 +155,23 @@ int main( int argc, char * argv[] )
 	nvIPFIX_datetime_t startTs = { 0 };
 	nvIPFIX_datetime_t endTs = { 0 };
 
-	if (!nvipfix_parse_datetime_iso8601( argv[argIndexTs], &startTs )
+	if (argIndexTs + 2 > (size_t)argc
+	    || !nvipfix_parse_datetime_iso8601( argv[argIndexTs], &startTs )
 	    || !nvipfix_parse_datetime_iso8601( argv[argIndexTs + 1], &endTs )) {
 		nvipfix_log_error( "invalid arguments" );
 		Usage();
 		return NV_IPFIX_RETURN_CODE_ARGS_ERROR;
 	}
 
+	if (!nvipfix_main_init()) {
+		return NV_IPFIX_RETURN_CODE_CONFIGURATION_ERROR;
+	}
+
 	if (useFile) {
-		nvipfix_main_export_file( argv[1] + 2, &startTs, &endTs );
+		nvipfix_main_export_files( (const char * const *)(argv + 1), argIndexTs - 1, &startTs, &endTs );
 	}
 	else {
-		int within_last;
-		within_last = nvipfix_datetime_to_ctime(&endTs) - nvipfix_datetime_to_ctime(&startTs);
-		nvipfix_main_export_nvc(&startTs, &endTs, within_last);
+		nvipfix_main_export_nvc( nvipfix_datetime_to_ctime( &startTs ), nvipfix_datetime_to_ctime( &endTs ), 0, NULL );
 	}
 
 	return NV_IPFIX_RETURN_CODE_OK;
@@ -223,6 +232,13 @@ int main_daemon( char * a_shmName )
 				dup( stdFileHandle );
 			}
 
+			/*
+			 * after the descriptors are closed: log4c opens its appenders here
+			 */
+			if (!nvipfix_main_init()) {
+				return NV_IPFIX_RETURN_CODE_CONFIGURATION_ERROR;
+			}
+
 			shmHandle = shm_open( a_shmName, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR | S_IROTH | S_IWOTH );
 
 			if (shmHandle < 0) {
@@ -254,23 +270,44 @@ int main_daemon( char * a_shmName )
 			*isRunning = true;
 #endif
 
-			nvIPFIX_datetime_t startTs = { 0 };
-			nvIPFIX_datetime_t endTs = { 0 };
-
 			time_t startT = time( NULL );
 			nvIPFIX_timespan_t exportInterval = nvipfix_config_get_export_interval();
 			int waitSeconds = NVIPFIX_TIMESPAN_GET_SECONDS( &exportInterval );
+			nvIPFIX_U32 deadlinePercent = nvipfix_config_get_nvc_poll_deadline();
+			time_t deadlineSeconds = (time_t)waitSeconds * deadlinePercent / 100;
+
+			/*
+			 * a poll running into the next interval would delay every export after it
+			 */
+			if (deadlinePercent > 0 && deadlineSeconds < 1) {
+				deadlineSeconds = 1;
+			}
 
+			time_t intervalSeconds = (waitSeconds > 0) ? waitSeconds : 1;
+			time_t wakeT = startT + intervalSeconds;
+
+			/*
+			 * each window starts where the previous one was fetched up to, the part of a window that
+			 * could not be fetched is kept for the next poll. Polls are due at interval boundaries
+			 * (a poll running over one skips it), not before the switch may be connected to again
+			 */
 			while (*isRunning) {
-#ifdef NVIPFIX_DEF_POSIX
-				sleep( waitSeconds );
-#endif
 				time_t nowT = time( NULL );
-				if (nvipfix_ctime_to_datetime( &startTs, &startT ) &&  nvipfix_ctime_to_datetime( &endTs, &nowT )) {
-					nvipfix_main_export_nvc( &startTs, &endTs, waitSeconds );
+
+#ifdef NVIPFIX_DEF_POSIX
+				if (wakeT > nowT) {
+					sleep( (unsigned)(wakeT - nowT) );
 				}
+#endif
+				nowT = time( NULL );
+
+				nvipfix_main_export_nvc( startT, nowT, (deadlinePercent > 0) ? nowT + deadlineSeconds : 0, &startT );
+
+				nowT = time( NULL );
+				time_t retryT = nvipfix_main_get_nvc_retry_time();
 
-				startT = nowT;
+				wakeT += (wakeT <= nowT) ? ((nowT - wakeT) / intervalSeconds + 1) * intervalSeconds : 0;
+				wakeT = (retryT > wakeT) ? retryT : wakeT;
 			}
 
 #ifdef NVIPFIX_DEF_POSIX
@@ -30,15 +30,20 @@
 #include "include/log.h"
 
 
-#define NVIPFIX_PARSE_UINT( a_s, a_value, a_type ) { \
-	unsigned long long ulValue = strtoull( a_s, NULL, 0 ); \
-	*((a_type *)a_value) = (a_type)ulValue; \
-	return true; }
+#define NVIPFIX_PARSE_UINT( a_s, a_value, a_type, a_max ) { \
+	nvIPFIX_U64 u64Value; \
+	bool isParsed = nvipfix_parse_integer_u64( a_s, &u64Value ) && u64Value <= (a_max); \
+	if (isParsed) { *((a_type *)a_value) = (a_type)u64Value; } \
+	return isParsed; }
 
-#define NVIPFIX_PARSE_INT( a_s, a_value, a_type ) { \
-	long long lValue = strtoll( a_s, NULL, 0 ); \
-	*((a_type *)a_value) = (a_type)lValue; \
-	return true; }
+#define NVIPFIX_PARSE_INT( a_s, a_value, a_type, a_min, a_max ) { \
+	nvIPFIX_I64 i64Value; \
+	bool isParsed = nvipfix_parse_integer_i64( a_s, &i64Value ) && i64Value >= (a_min) && i64Value <= (a_max); \
+	if (isParsed) { *((a_type *)a_value) = (a_type)i64Value; } \
+	return isParsed; }
+
+#define NVIPFIX_SWAR_ONES 0x0101010101010101ULL
+#define NVIPFIX_SWAR_DECIMAL_DIGITS_MAX_U64 20
 
 #define NVIPFIX_TM_INIT_FROM_DT( a_varName, a_datetime ) \
 	struct tm a_varName = { 0 };	\
@@ -60,10 +65,19 @@
 	NVIPFIX_TIMESPAN_SET_SECONDS( (a_datetime)->tzOffset, 0 )
 
 
+static bool nvipfix_parse_integer_u64( const char *, nvIPFIX_U64 * );
+static bool nvipfix_parse_integer_i64( const char *, nvIPFIX_I64 * );
+static size_t nvipfix_parse_trim_span( const char * *, size_t );
+
+
 enum {
 	SizeofStringList = sizeof (nvIPFIX_string_list_t),
 	SizeofStringListItem = sizeof (nvIPFIX_string_list_item_t),
-	SizeofCharset = 1 << (sizeof (nvIPFIX_CHAR) * CHAR_BIT)
+	SizeofCharset = 1 << (sizeof (nvIPFIX_CHAR) * CHAR_BIT),
+	SizeofIso8601 = sizeof "YYYY-MM-DDTHH:MM:SS" - 1,
+	SizeofIpv4Min = sizeof "0.0.0.0" - 1,
+	SizeofIpv4Max = sizeof "255.255.255.255" - 1,
+	SizeofMac = sizeof "hh:hh:hh:hh:hh:hh" - 1
 };
 
 
@@ -489,6 +503,265 @@ nvIPFIX_CHAR * nvipfix_string_duplicate( const nvIPFIX_CHAR * a_s )
 	return result;
 }
 
+/*
+ * load 8 characters so that the first one is in the lowest byte
+ */
+static inline uint64_t nvipfix_swar_load( const nvIPFIX_CHAR * a_s )
+{
+	uint64_t result;
+
+	memcpy( &result, a_s, sizeof result );
+
+#if defined (__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	result = __builtin_bswap64( result );
+#endif
+
+	return result;
+}
+
+static inline bool nvipfix_swar_is_8_digits( uint64_t a_chars )
+{
+	return ((a_chars & (0xf0 * NVIPFIX_SWAR_ONES))
+			| (((a_chars + 0x06 * NVIPFIX_SWAR_ONES) & (0xf0 * NVIPFIX_SWAR_ONES)) >> 4)) == 0x33 * NVIPFIX_SWAR_ONES;
+}
+
+/*
+ * combine digit pairs, then quads, then both halves: 3 multiplications for 8 digits
+ */
+static inline uint32_t nvipfix_swar_parse_8_digits( uint64_t a_chars )
+{
+	a_chars -= '0' * NVIPFIX_SWAR_ONES;
+	a_chars = (a_chars * 10) + (a_chars >> 8);
+	a_chars = (((a_chars & 0x000000ff000000ffULL) * 0x000f424000000064ULL)
+			+ (((a_chars >> 16) & 0x000000ff000000ffULL) * 0x0000271000000001ULL)) >> 32;
+
+	return (uint32_t)a_chars;
+}
+
+/*
+ * exactly a_count digits
+ */
+static inline bool nvipfix_parse_digits( const nvIPFIX_CHAR * a_s, size_t a_count, int * a_value )
+{
+	int value = 0;
+
+	for (size_t i = 0; i < a_count; i++) {
+		unsigned digit = (unsigned)(nvIPFIX_BYTE)a_s[i] - '0';
+
+		if (digit > 9) {
+			return false;
+		}
+
+		value = value * 10 + digit;
+	}
+
+	*a_value = value;
+
+	return true;
+}
+
+static inline int nvipfix_days_in_month( int a_year, int a_month )
+{
+	static const int DaysInMonth[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+	bool isLeap = (a_year % 4 == 0 && a_year % 100 != 0) || a_year % 400 == 0;
+
+	return DaysInMonth[a_month - 1] + ((a_month == 2 && isLeap) ? 1 : 0);
+}
+
+/*
+ * days since 1970-01-01 of a proleptic Gregorian date
+ */
+static nvIPFIX_I64 nvipfix_days_from_civil( int a_year, int a_month, int a_day )
+{
+	int year = a_year - (a_month <= 2 ? 1 : 0);
+	int era = (year >= 0 ? year : year - 399) / 400;
+	unsigned yearOfEra = (unsigned)(year - era * 400);
+	unsigned dayOfYear = (153 * (a_month + (a_month > 2 ? -3 : 9)) + 2) / 5 + a_day - 1;
+	unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+
+	return (nvIPFIX_I64)era * 146097 + dayOfEra - 719468;
+}
+
+/*
+ * seconds since 1970-01-01T00:00:00 of the broken-down fields, ignoring any zone (timegm)
+ */
+static nvIPFIX_I64 nvipfix_tm_get_seconds( const struct tm * a_tm )
+{
+	return ((nvipfix_days_from_civil( a_tm->tm_year + 1900, a_tm->tm_mon + 1, a_tm->tm_mday )
+			* NVIPFIX_HOURS_PER_DAY + a_tm->tm_hour)
+			* NVIPFIX_MINUTES_PER_HOUR + a_tm->tm_min)
+			* NVIPFIX_SECONDS_PER_MINUTE + a_tm->tm_sec;
+}
+
+static inline unsigned nvipfix_hex_digit( nvIPFIX_CHAR a_c, bool * a_isValid )
+{
+	unsigned digit = (unsigned)(nvIPFIX_BYTE)a_c - '0';
+	unsigned letter = ((unsigned)(nvIPFIX_BYTE)a_c | 0x20) - 'a';
+
+	*a_isValid = digit <= 9 || letter <= 5;
+
+	return (digit <= 9) ? digit : letter + 10;
+}
+
+nvIPFIX_PARSE_STATUS nvipfix_parse_decimal_u64( const nvIPFIX_CHAR * a_s, size_t a_len, nvIPFIX_U64 * a_value )
+{
+	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, NV_IPFIX_PARSE_STATUS_INVALID );
+
+	if (a_len == 0) {
+		return NV_IPFIX_PARSE_STATUS_INVALID;
+	}
+
+	size_t i = 0;
+
+	while (i < a_len && a_s[i] == '0') {
+		i++;
+	}
+
+	if (a_len - i > NVIPFIX_SWAR_DECIMAL_DIGITS_MAX_U64) {
+		for (; i < a_len; i++) {
+			if ((unsigned)(nvIPFIX_BYTE)a_s[i] - '0' > 9) {
+				return NV_IPFIX_PARSE_STATUS_INVALID;
+			}
+		}
+
+		return NV_IPFIX_PARSE_STATUS_OVERFLOW;
+	}
+
+	nvIPFIX_PARSE_STATUS result = NV_IPFIX_PARSE_STATUS_OK;
+	nvIPFIX_U64 value = 0;
+
+	/*
+	 * at most 2 blocks fit before the last 4 digits of UINT64_MAX: no overflow check needed here
+	 */
+	while (a_len - i >= 8) {
+		uint64_t chars = nvipfix_swar_load( a_s + i );
+
+		if (!nvipfix_swar_is_8_digits( chars )) {
+			return NV_IPFIX_PARSE_STATUS_INVALID;
+		}
+
+		value = value * 100000000 + nvipfix_swar_parse_8_digits( chars );
+		i += 8;
+	}
+
+	for (; i < a_len; i++) {
+		unsigned digit = (unsigned)(nvIPFIX_BYTE)a_s[i] - '0';
+
+		if (digit > 9) {
+			return NV_IPFIX_PARSE_STATUS_INVALID;
+		}
+
+		if (value > (UINT64_MAX - digit) / 10) {
+			result = NV_IPFIX_PARSE_STATUS_OVERFLOW;
+		}
+
+		value = value * 10 + digit;
+	}
+
+	if (result == NV_IPFIX_PARSE_STATUS_OK) {
+		*a_value = value;
+	}
+
+	return result;
+}
+
+nvIPFIX_PARSE_STATUS nvipfix_parse_decimal_i64( const nvIPFIX_CHAR * a_s, size_t a_len, nvIPFIX_I64 * a_value )
+{
+	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, NV_IPFIX_PARSE_STATUS_INVALID );
+
+	bool isNegative = a_len > 0 && a_s[0] == '-';
+
+	if (a_len > 0 && (isNegative || a_s[0] == '+')) {
+		a_s++;
+		a_len--;
+	}
+
+	nvIPFIX_U64 magnitude;
+	nvIPFIX_PARSE_STATUS result = nvipfix_parse_decimal_u64( a_s, a_len, &magnitude );
+
+	if (result == NV_IPFIX_PARSE_STATUS_OK) {
+		if (magnitude > (nvIPFIX_U64)INT64_MAX + isNegative) {
+			result = NV_IPFIX_PARSE_STATUS_OVERFLOW;
+		}
+		else {
+			*a_value = isNegative ? (nvIPFIX_I64)(0 - magnitude) : (nvIPFIX_I64)magnitude;
+		}
+	}
+
+	return result;
+}
+
+/*
+ * decimal, or hexadecimal with 0x prefix
+ */
+/**
+ * skip the blanks around a value, as strtoull() did for the padded values of older captures
+ * @param a_s [in, out] moved to the first non-blank character
+ * @param a_len
+ * @return length without the blanks
+ */
+size_t nvipfix_parse_trim_span( const char * * a_s, size_t a_len )
+{
+	const char * s = *a_s;
+	size_t len = a_len;
+
+	while (len > 0 && (*s == ' ' || *s == '\t' || *s == '\r' || *s == '\n')) {
+		s++;
+		len--;
+	}
+
+	while (len > 0 && (s[len - 1] == ' ' || s[len - 1] == '\t' || s[len - 1] == '\r' || s[len - 1] == '\n')) {
+		len--;
+	}
+
+	*a_s = s;
+
+	return len;
+}
+
+bool nvipfix_parse_integer_i64( const char * a_s, nvIPFIX_I64 * a_value )
+{
+	const char * s = a_s;
+	size_t len = nvipfix_parse_trim_span( &s, strlen( a_s ) );
+
+	return nvipfix_parse_decimal_i64( s, len, a_value ) == NV_IPFIX_PARSE_STATUS_OK;
+}
+
+bool nvipfix_parse_integer_u64( const char * a_s, nvIPFIX_U64 * a_value )
+{
+	const char * s = a_s;
+	size_t len = nvipfix_parse_trim_span( &s, strlen( a_s ) );
+
+	if (len < 3 || s[0] != '0' || (s[1] | 0x20) != 'x') {
+		return nvipfix_parse_decimal_u64( s, len, a_value ) == NV_IPFIX_PARSE_STATUS_OK;
+	}
+
+	nvIPFIX_U64 value = 0;
+
+	for (size_t i = 2; i < len; i++) {
+		unsigned digit = (unsigned)(nvIPFIX_BYTE)s[i] - '0';
+
+		if (digit > 9) {
+			digit = ((unsigned)(nvIPFIX_BYTE)s[i] | 0x20) - 'a' + 10;
+
+			if (digit < 10 || digit > 15) {
+				return false;
+			}
+		}
+
+		if (value >> 60 != 0) {
+			return false;
+		}
+
+		value = (value << 4) | digit;
+	}
+
+	*a_value = value;
+
+	return true;
+}
+
 bool nvipfix_parse_string( const char * a_s, void * a_value )
 {
 	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
@@ -504,126 +777,139 @@ bool nvipfix_parse_int( const char * a_s, void * a_value )
 {
 	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
 
-	NVIPFIX_PARSE_INT( a_s, a_value, int );
+	NVIPFIX_PARSE_INT( a_s, a_value, int, INT_MIN, INT_MAX );
 }
 
 bool nvipfix_parse_unsigned( const char * a_s, void * a_value )
 {
 	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
 
-	NVIPFIX_PARSE_UINT( a_s, a_value, unsigned );
+	NVIPFIX_PARSE_UINT( a_s, a_value, unsigned, UINT_MAX );
 }
 
 bool nvipfix_parse_octet( const char * a_s, void * a_value )
 {
 	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
 
-	NVIPFIX_PARSE_UINT( a_s, a_value, nvIPFIX_OCTET );
+	NVIPFIX_PARSE_UINT( a_s, a_value, nvIPFIX_OCTET, UINT8_MAX );
 }
 
 bool nvipfix_parse_byte( const char * a_s, void * a_value )
 {
 	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
 
-	NVIPFIX_PARSE_UINT( a_s, a_value, nvIPFIX_BYTE );
+	NVIPFIX_PARSE_UINT( a_s, a_value, nvIPFIX_BYTE, UINT8_MAX );
 }
 
 bool nvipfix_parse_u16( const char * a_s, void * a_value )
 {
 	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
 
-	NVIPFIX_PARSE_UINT( a_s, a_value, nvIPFIX_U16 );
+	NVIPFIX_PARSE_UINT( a_s, a_value, nvIPFIX_U16, UINT16_MAX );
 }
 
 bool nvipfix_parse_u32( const char * a_s, void * a_value )
 {
 	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
 
-	NVIPFIX_PARSE_UINT( a_s, a_value, nvIPFIX_U32 );
+	NVIPFIX_PARSE_UINT( a_s, a_value, nvIPFIX_U32, UINT32_MAX );
 }
 
 bool nvipfix_parse_i64( const char * a_s, void * a_value )
 {
 	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
 
-	NVIPFIX_PARSE_INT( a_s, a_value, nvIPFIX_I64 );
+	NVIPFIX_PARSE_INT( a_s, a_value, nvIPFIX_I64, INT64_MIN, INT64_MAX );
 }
 
 bool nvipfix_parse_u64( const char * a_s, void * a_value )
 {
 	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
 
-	NVIPFIX_PARSE_UINT( a_s, a_value, nvIPFIX_U64 );
+	NVIPFIX_PARSE_UINT( a_s, a_value, nvIPFIX_U64, UINT64_MAX );
 }
 
 bool nvipfix_parse_ip_address( const char * a_s, void * a_value )
 {
 	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
 
-	bool result = false;
-
-	nvIPFIX_string_list_t * tokens = nvipfix_string_split( a_s, "." );
-
-	if (tokens == NULL) {
-		return result;
-	}
-
-	nvIPFIX_ip_address_t * address = a_value;
-
-	if (tokens->count == NV_IPFIX_ADDRESS_OCTETS_COUNT_IPV4) {
-		nvIPFIX_string_list_item_t * token = tokens->head;
-
-		address->value = 0;
-		size_t index = 0;
-
-		while (token != NULL) {
-			index++;
-			address->value |= ((nvIPFIX_OCTET)strtoul( token->value, NULL, 0 )) << (32 - 8 * index);
-
-			token = token->next;
-		}
-
-		result = (index == NV_IPFIX_ADDRESS_OCTETS_COUNT_IPV4);
-	}
-
-	nvipfix_string_list_free( tokens, true );
-
-	address->hasValue = result;
-
-	return result;
+	return nvipfix_ip_address_parse( a_s, strlen( a_s ), a_value );
 }
 
 bool nvipfix_parse_mac_address( const char * a_s, void * a_value )
 {
-	bool result = false;
-
 	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
 
-	nvIPFIX_string_list_t * tokens = nvipfix_string_split( a_s, ":" );
+	return nvipfix_mac_address_parse( a_s, strlen( a_s ), a_value );
+}
 
-	if (tokens == NULL) {
-		return result;
+bool nvipfix_ip_address_parse( const nvIPFIX_CHAR * a_s, size_t a_len, nvIPFIX_ip_address_t * a_address )
+{
+	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_address, false );
+
+	nvIPFIX_U32 value = 0;
+	unsigned octet = 0;
+	unsigned digitsCount = 0;
+	unsigned dotsCount = 0;
+	bool result = a_len >= SizeofIpv4Min && a_len <= SizeofIpv4Max;
+
+	/*
+	 * validity is accumulated, the only branch is on the separator
+	 */
+	for (size_t i = 0; result && i < a_len; i++) {
+		unsigned digit = (unsigned)(nvIPFIX_BYTE)a_s[i] - '0';
+
+		if (a_s[i] == '.') {
+			result = digitsCount > 0;
+			value = (value << 8) | octet;
+			octet = 0;
+			digitsCount = 0;
+			dotsCount++;
+		}
+		else {
+			octet = octet * 10 + digit;
+			digitsCount++;
+			result = digit <= 9 && octet <= UINT8_MAX && digitsCount <= 3;
+		}
 	}
 
-	nvIPFIX_mac_address_t * address = a_value;
+	result = result && dotsCount == NV_IPFIX_ADDRESS_OCTETS_COUNT_IPV4 - 1 && digitsCount > 0;
 
-	if (tokens->count == NV_IPFIX_ADDRESS_OCTETS_COUNT_MAC) {
-		nvIPFIX_string_list_item_t * token = tokens->head;
+	if (result) {
+		a_address->value = (value << 8) | octet;
+	}
 
-		size_t index = 0;
+	a_address->hasValue = result;
 
-		while (token != NULL) {
-			address->octets[index] = (nvIPFIX_OCTET)strtoul( token->value, NULL, 16 );
-			index++;
-			token = token->next;
-		}
+	return result;
+}
 
-		result = (index == NV_IPFIX_ADDRESS_OCTETS_COUNT_MAC);
+bool nvipfix_mac_address_parse( const nvIPFIX_CHAR * a_s, size_t a_len, nvIPFIX_mac_address_t * a_address )
+{
+	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_address, false );
+
+	nvIPFIX_OCTET octets[NV_IPFIX_ADDRESS_OCTETS_COUNT_MAC];
+	bool result = a_len == SizeofMac;
+
+	/*
+	 * fixed layout hh:hh:hh:hh:hh:hh, no branches per digit
+	 */
+	for (size_t i = 0; result && i < NV_IPFIX_ADDRESS_OCTETS_COUNT_MAC; i++) {
+		const nvIPFIX_CHAR * s = a_s + i * 3;
+		bool isHigh;
+		bool isLow;
+		unsigned high = nvipfix_hex_digit( s[0], &isHigh );
+		unsigned low = nvipfix_hex_digit( s[1], &isLow );
+
+		octets[i] = (nvIPFIX_OCTET)((high << 4) | low);
+		result = isHigh & isLow & (i + 1 == NV_IPFIX_ADDRESS_OCTETS_COUNT_MAC || s[2] == ':');
 	}
 
-	nvipfix_string_list_free( tokens, true );
+	if (result) {
+		memcpy( a_address->octets, octets, sizeof octets );
+	}
 
-	address->hasValue = result;
+	a_address->hasValue = result;
 
 	return result;
 }
@@ -632,64 +918,100 @@ bool nvipfix_parse_datetime_iso8601( const char * a_s, void * a_value )
 {
 	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_value, false );
 
-	bool result = false;
-	nvIPFIX_string_list_t * tokens = nvipfix_string_split( a_s, "T" );
-	nvIPFIX_datetime_t * datetime = a_value;
-
-	if (tokens != NULL) {
-		if (tokens->count == 2) {
-			nvIPFIX_string_list_t * dateTokens = nvipfix_string_split( tokens->head->value, "-" );
+	return nvipfix_datetime_parse_iso8601( a_s, strlen( a_s ), a_value, NULL );
+}
 
-			if (dateTokens != NULL) {
-				if (dateTokens->count == 3) {
-					unsigned value;
+bool nvipfix_datetime_parse_iso8601( const nvIPFIX_CHAR * a_s, size_t a_len, nvIPFIX_datetime_t * a_datetime,
+		nvIPFIX_I64 * a_microseconds )
+{
+	NVIPFIX_NULL_ARGS_GUARD_2( a_s, a_datetime, false );
+
+	nvIPFIX_datetime_t datetime = { 0 };
+	int microseconds = 0;
+	int tzMinutes = 0;
+
+	/*
+	 * YYYY-MM-DDTHH:MM:SS
+	 */
+	bool result = a_len >= SizeofIso8601
+			&& a_s[4] == '-' && a_s[7] == '-' && a_s[10] == 'T' && a_s[13] == ':' && a_s[16] == ':'
+			&& nvipfix_parse_digits( a_s, 4, &(datetime.year) )
+			&& nvipfix_parse_digits( a_s + 5, 2, &(datetime.month) )
+			&& nvipfix_parse_digits( a_s + 8, 2, &(datetime.day) )
+			&& nvipfix_parse_digits( a_s + 11, 2, &(datetime.hours) )
+			&& nvipfix_parse_digits( a_s + 14, 2, &(datetime.minutes) )
+			&& nvipfix_parse_digits( a_s + 17, 2, &(datetime.seconds) )
+			&& datetime.month >= 1 && datetime.month <= 12
+			&& datetime.day >= 1 && datetime.day <= nvipfix_days_in_month( datetime.year, datetime.month )
+			&& datetime.hours <= 23 && datetime.minutes <= 59 && datetime.seconds <= 60;
+
+	size_t i = SizeofIso8601;
+
+	/*
+	 * [.fff], digits past microseconds are ignored
+	 */
+	if (result && i < a_len && a_s[i] == '.') {
+		size_t digitsCount = 0;
+
+		for (i++; i < a_len && (unsigned)(nvIPFIX_BYTE)a_s[i] - '0' <= 9; i++, digitsCount++) {
+			if (digitsCount < 6) {
+				microseconds = microseconds * 10 + (a_s[i] - '0');
+			}
+		}
 
-					if (nvipfix_parse_unsigned( dateTokens->head->value, &value )) {
-						datetime->year = value;
+		for (size_t j = digitsCount; j < 6; j++) {
+			microseconds *= 10;
+		}
 
-						if (nvipfix_parse_unsigned( dateTokens->head->next->value, &value )) {
-							datetime->month = value;
+		result = digitsCount > 0;
+	}
 
-							if (nvipfix_parse_unsigned( dateTokens->tail->value, &value )) {
-								datetime->day = value;
+	/*
+	 * [Z|+hh[:mm]|-hh[:mm]]
+	 */
+	if (result && i < a_len) {
+		if (a_s[i] == 'Z') {
+			i++;
+		}
+		else if (a_s[i] == '+' || a_s[i] == '-') {
+			int tzHours = 0;
+			int tzMinutesPart = 0;
+			size_t j = i + 3;
 
-								nvIPFIX_string_list_t * timeTokens = nvipfix_string_split( tokens->tail->value, ":" );
+			result = a_len >= j && nvipfix_parse_digits( a_s + i + 1, 2, &tzHours ) && tzHours <= 23;
 
-								if (timeTokens != NULL) {
-									if (timeTokens->count == 3) {
+			if (result && j < a_len) {
+				j += (a_s[j] == ':') ? 1 : 0;
+				result = a_len >= j + 2 && nvipfix_parse_digits( a_s + j, 2, &tzMinutesPart ) && tzMinutesPart <= 59;
+				j += 2;
+			}
 
-										if (nvipfix_parse_unsigned( timeTokens->head->value, &value )) {
-											datetime->hours = value;
+			tzMinutes = (tzHours * NVIPFIX_MINUTES_PER_HOUR + tzMinutesPart) * ((a_s[i] == '-') ? -1 : 1);
+			i = j;
+		}
 
-											if (nvipfix_parse_unsigned( timeTokens->head->next->value, &value )) {
-												datetime->minutes = value;
+		result = result && i == a_len;
+	}
 
-												if (nvipfix_parse_unsigned( timeTokens->tail->value, &value )) {
-													datetime->seconds = value;
-													datetime->milliseconds = 0;
+	if (result) {
+		datetime.milliseconds = microseconds / NVIPFIX_MICROSECONDS_PER_MILLISECOND;
 
-													result = true;
-												}
-											}
-										}
-									}
+		/*
+		 * fields + tzOffset = UTC, as for nvipfix_ctime_to_datetime
+		 */
+		NVIPFIX_TIMESPAN_SET_SECONDS( datetime.tzOffset, -(nvIPFIX_I64)tzMinutes * NVIPFIX_SECONDS_PER_MINUTE );
+		datetime.hasValue = true;
 
-									nvipfix_string_list_free( timeTokens, true );
-								}
-							}
-						}
-					}
-				}
+		*a_datetime = datetime;
 
-				nvipfix_string_list_free( dateTokens, true );
-			}
+		if (a_microseconds != NULL) {
+			*a_microseconds = nvipfix_datetime_get_microseconds_since_epoch( &datetime )
+					+ microseconds % NVIPFIX_MICROSECONDS_PER_MILLISECOND;
 		}
-
-		nvipfix_string_list_free( tokens, true );
 	}
-
-	datetime->hasValue = result;
-	NVIPFIX_TIMESPAN_SET_SECONDS( datetime->tzOffset, 0 );
+	else {
+		a_datetime->hasValue = false;
+	}
 
 	return result;
 }
@@ -776,27 +1098,34 @@ const nvIPFIX_CHAR * nvipfix_ip_address_to_string( const nvIPFIX_ip_address_t *
 
 nvIPFIX_U32 nvipfix_datetime_get_seconds_since_epoch( const nvIPFIX_datetime_t * a_datetime, int a_epoch_year, int a_epoch_month )
 {
-	nvIPFIX_U32 result = 0;
+	NVIPFIX_NULL_ARGS_GUARD_1( a_datetime, 0 );
 
-	struct tm epoch = { 0 };
-	epoch.tm_year = a_epoch_year - 1900;
-	epoch.tm_mon = a_epoch_month - 1;
-	epoch.tm_mday = 1;
+	nvIPFIX_I64 epochSeconds = nvipfix_days_from_civil( a_epoch_year, a_epoch_month, 1 )
+			* NVIPFIX_HOURS_PER_DAY * NVIPFIX_MINUTES_PER_HOUR * NVIPFIX_SECONDS_PER_MINUTE;
 
-	NVIPFIX_TM_INIT_FROM_DT( datetime, a_datetime );
+	return (nvIPFIX_U32)(nvipfix_datetime_get_microseconds_since_epoch( a_datetime )
+			/ (NVIPFIX_MICROSECONDS_PER_MILLISECOND * NVIPFIX_MILLISECONDS_PER_SECOND) - epochSeconds);
+}
 
-	result = difftime( mktime( &datetime ), mktime( &epoch ) );
+nvIPFIX_I64 nvipfix_datetime_get_microseconds_since_epoch( const nvIPFIX_datetime_t * a_datetime )
+{
+	NVIPFIX_NULL_ARGS_GUARD_1( a_datetime, 0 );
 
-	return result;
+	nvIPFIX_I64 seconds = ((nvipfix_days_from_civil( a_datetime->year, a_datetime->month, a_datetime->day )
+			* NVIPFIX_HOURS_PER_DAY + a_datetime->hours)
+			* NVIPFIX_MINUTES_PER_HOUR + a_datetime->minutes)
+			* NVIPFIX_SECONDS_PER_MINUTE + a_datetime->seconds;
+
+	return (seconds * NVIPFIX_MILLISECONDS_PER_SECOND + a_datetime->milliseconds) * NVIPFIX_MICROSECONDS_PER_MILLISECOND
+			+ nvipfix_timespan_get_microseconds( &(a_datetime->tzOffset) );
 }
 
 time_t nvipfix_datetime_to_ctime( const nvIPFIX_datetime_t * a_datetime )
 {
 	NVIPFIX_NULL_ARGS_GUARD_1( a_datetime, (time_t)-1 );
 
-	NVIPFIX_TM_INIT_FROM_DT( datetime, a_datetime );
-
-	return mktime( &datetime );
+	return (time_t)(nvipfix_datetime_get_microseconds_since_epoch( a_datetime )
+			/ (NVIPFIX_MICROSECONDS_PER_MILLISECOND * NVIPFIX_MILLISECONDS_PER_SECOND));
 }
 
 bool nvipfix_ctime_to_datetime( nvIPFIX_datetime_t * a_datetime, const time_t * a_ctime )
@@ -814,7 +1143,7 @@ bool nvipfix_ctime_to_datetime( nvIPFIX_datetime_t * a_datetime, const time_t *
 	}
 
 	NVIPFIX_DT_FROM_TM( a_datetime, datetime );
-	NVIPFIX_TIMESPAN_SET_SECONDS( a_datetime->tzOffset, difftime( mktime( &datetimeUtc ), *a_ctime ) );
+	NVIPFIX_TIMESPAN_SET_SECONDS( a_datetime->tzOffset, nvipfix_tm_get_seconds( &datetimeUtc ) - nvipfix_tm_get_seconds( &datetime ) );
 
 	a_datetime->hasValue = result;
 
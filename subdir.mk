@@ -3,6 +3,7 @@ C_SRCS += \
 $(DIR_SRC)/config.c \
 $(DIR_SRC)/data.c \
 $(DIR_SRC)/export.c \
+$(DIR_SRC)/flowcache.c \
 $(DIR_SRC)/fwatch.c \
 $(DIR_SRC)/import.c \
 $(DIR_SRC)/log.c \
@@ -16,6 +17,7 @@ OBJS += \
 $(DIR_OBJ)/config.o \
 $(DIR_OBJ)/data.o \
 $(DIR_OBJ)/export.o \
+$(DIR_OBJ)/flowcache.o \
 $(DIR_OBJ)/fwatch.o \
 $(DIR_OBJ)/import.o \
 $(DIR_OBJ)/log.o \
@@ -29,6 +31,7 @@ C_DEPS += \
 $(DIR_DEP)/config.d \
 $(DIR_DEP)/data.d \
 $(DIR_DEP)/export.d \
+$(DIR_DEP)/flowcache.d \
 $(DIR_DEP)/fwatch.d \
 $(DIR_DEP)/import.d \
 $(DIR_DEP)/log.d \